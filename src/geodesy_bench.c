@@ -0,0 +1,174 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "nmea.h"
+
+// Compares the batch geodesy functions against a plain C library implementation and times them, errors are absolute
+// Build it with and without NMEA_GEODESY_SIMD to compare the SIMD and scalar paths
+
+#define POINTS 4096
+#define ROUNDS 200
+
+#define PI 3.14159265358979323846
+#define DEG_TO_RAD (PI / 180.0)
+#define EARTH_RADIUS 6371008.8
+#define WGS84_A 6378137.0
+#define WGS84_F (1.0 / 298.257223563)
+#define WGS84_E2 (WGS84_F * (2.0 - WGS84_F))
+
+static nmea_coordinate_t coords[POINTS];
+static char hemispheres[POINTS];
+static double latitudes[POINTS], longitudes[POINTS], altitudes[POINTS];
+static double x[POINTS], y[POINTS], z[POINTS];
+static double output[3][POINTS], expected[3][POINTS];
+static uint32_t times[POINTS];
+
+static int failures = 0;
+
+static double now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double random_between(double min, double max) {
+	return min + (max - min) * (rand() / (double) RAND_MAX);
+}
+
+static void fill(void) {
+	srand(1);
+
+	for (int i = 0; i < POINTS; i++) {
+		// Half a track with small steps, half scattered around the globe
+		if (i < POINTS / 2) {
+			latitudes[i] = i == 0 ? 44.0 : latitudes[i - 1] + random_between(-1e-4, 1e-4);
+			longitudes[i] = i == 0 ? -121.3 : longitudes[i - 1] + random_between(-1e-4, 1e-4);
+		} else {
+			latitudes[i] = random_between(-90.0, 90.0);
+			longitudes[i] = random_between(-180.0, 180.0);
+		}
+
+		altitudes[i] = random_between(-100.0, 9000.0);
+		times[i] = (86399000 + i * 1000) % 86400000; // Crosses midnight
+
+		double degrees = fabs(latitudes[i]);
+		coords[i].degrees = (uint8_t) degrees;
+		coords[i].decimal_minutes = (degrees - coords[i].degrees) * 60.0;
+		hemispheres[i] = latitudes[i] < 0 ? 'S' : 'N';
+	}
+}
+
+static double max_error(int outputs, int count) {
+	double error = 0.0;
+
+	for (int o = 0; o < outputs; o++) {
+		for (int i = 0; i < count; i++) {
+			double e = fabs(output[o][i] - expected[o][i]);
+
+			if (!(e <= error)) {
+				error = e;
+			}
+		}
+	}
+
+	return error;
+}
+
+// Times the call, then compares every output array against the expected ones
+#define BENCH(name, unit, outputs, count, tolerance, call) do { \
+	double start = now_ns(); \
+	for (int round = 0; round < ROUNDS; round++) { \
+		call; \
+	} \
+	double elapsed_ns = now_ns() - start; \
+	double error = max_error(outputs, count); \
+	bool ok = error <= (tolerance); \
+	failures += !ok; \
+	printf("%-26s %8.2f ns/pt  max error %.2e %-3s %s\n", name, elapsed_ns / ((double) ROUNDS * (count)), error, unit, ok ? "OK" : "FAIL"); \
+} while (0)
+
+int main(void) {
+	fill();
+
+#if NMEA_GEODESY_SIMD
+	printf("SIMD enabled\n");
+#else
+	printf("SIMD disabled\n");
+#endif
+
+	for (int i = 0; i < POINTS; i++) {
+		expected[0][i] = (hemispheres[i] == 'S' ? -1.0 : 1.0) * (coords[i].degrees + coords[i].decimal_minutes / 60.0);
+	}
+
+	BENCH("nmea_get_coordinates_dd", "deg", 1, POINTS, 1e-12, nmea_get_coordinates_dd(coords, hemispheres, output[0], POINTS));
+
+	for (int i = 0; i < POINTS; i++) {
+		double sin_lat = sin(latitudes[i] * DEG_TO_RAD), cos_lat = cos(latitudes[i] * DEG_TO_RAD);
+		double n = WGS84_A / sqrt(1.0 - WGS84_E2 * sin_lat * sin_lat);
+		expected[0][i] = (n + altitudes[i]) * cos_lat * cos(longitudes[i] * DEG_TO_RAD);
+		expected[1][i] = (n + altitudes[i]) * cos_lat * sin(longitudes[i] * DEG_TO_RAD);
+		expected[2][i] = (n * (1.0 - WGS84_E2) + altitudes[i]) * sin_lat;
+	}
+
+	BENCH("nmea_get_ecef", "m", 3, POINTS, 1e-6, nmea_get_ecef(latitudes, longitudes, altitudes, output[0], output[1], output[2], POINTS));
+
+	// The ENU input is the reference ECEF
+	for (int i = 0; i < POINTS; i++) {
+		x[i] = expected[0][i];
+		y[i] = expected[1][i];
+		z[i] = expected[2][i];
+	}
+
+	double sin_lat = sin(latitudes[0] * DEG_TO_RAD), cos_lat = cos(latitudes[0] * DEG_TO_RAD);
+	double sin_lon = sin(longitudes[0] * DEG_TO_RAD), cos_lon = cos(longitudes[0] * DEG_TO_RAD);
+
+	for (int i = 0; i < POINTS; i++) {
+		double dx = x[i] - x[0], dy = y[i] - y[0], dz = z[i] - z[0];
+		expected[0][i] = -sin_lon * dx + cos_lon * dy;
+		expected[1][i] = -sin_lat * cos_lon * dx - sin_lat * sin_lon * dy + cos_lat * dz;
+		expected[2][i] = cos_lat * cos_lon * dx + cos_lat * sin_lon * dy + sin_lat * dz;
+	}
+
+	BENCH("nmea_get_enu", "m", 3, POINTS, 1e-6, nmea_get_enu(latitudes[0], longitudes[0], altitudes[0], x, y, z, output[0], output[1], output[2], POINTS));
+
+	for (int i = 0; i < POINTS - 1; i++) {
+		double lat1 = latitudes[i] * DEG_TO_RAD, lat2 = latitudes[i + 1] * DEG_TO_RAD;
+		double sin_dlat = sin((lat2 - lat1) * 0.5);
+		double sin_dlon = sin((longitudes[i + 1] - longitudes[i]) * DEG_TO_RAD * 0.5);
+		double a = sin_dlat * sin_dlat + cos(lat1) * cos(lat2) * sin_dlon * sin_dlon;
+		expected[0][i] = 2.0 * EARTH_RADIUS * atan2(sqrt(a), sqrt(1.0 - a));
+	}
+
+	BENCH("nmea_get_haversine", "m", 1, POINTS - 1, 1e-6, nmea_get_haversine_distances(latitudes, longitudes, output[0], POINTS));
+
+	for (int i = 0; i < POINTS - 1; i++) {
+		double dx = remainder(longitudes[i + 1] - longitudes[i], 360.0) * DEG_TO_RAD * cos((latitudes[i] + latitudes[i + 1]) * 0.5 * DEG_TO_RAD);
+		double dy = (latitudes[i + 1] - latitudes[i]) * DEG_TO_RAD;
+		expected[0][i] = EARTH_RADIUS * sqrt(dx * dx + dy * dy);
+	}
+
+	BENCH("nmea_get_equirectangular", "m", 1, POINTS - 1, 1e-6, nmea_get_equirectangular_distances(latitudes, longitudes, output[0], POINTS));
+
+	for (int i = 0; i < POINTS - 1; i++) {
+		double lat1 = latitudes[i] * DEG_TO_RAD, lat2 = latitudes[i + 1] * DEG_TO_RAD;
+		double dlon = (longitudes[i + 1] - longitudes[i]) * DEG_TO_RAD;
+		double bearing = atan2(sin(dlon) * cos(lat2), cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dlon)) / DEG_TO_RAD;
+		expected[0][i] = bearing < 0.0 ? bearing + 360.0 : bearing;
+	}
+
+	// Steps of a few meters cancel in the bearing formula, amplifying the last bit differences of sin and cos
+	BENCH("nmea_get_bearings", "deg", 1, POINTS - 1, 1e-7, nmea_get_bearings(latitudes, longitudes, output[0], POINTS));
+
+	for (int i = 0; i < POINTS - 1; i++) {
+		x[i] = random_between(0.0, 50.0);
+		expected[0][i] = x[i]; // One second apart
+	}
+
+	BENCH("nmea_get_speeds", "m/s", 1, POINTS - 1, 1e-12, nmea_get_speeds(x, times, output[0], POINTS));
+
+	return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -15,10 +15,11 @@ extern "C" {
 
 /**
  * NMEA character buffer max length
- * Defaults to 164 characters, enough space to fit two messages (or partial messages)
+ * Defaults to 165 characters, enough space to fit two messages (or partial messages)
+ * One slot is always kept empty to tell a full buffer from an empty one
  */
 #ifndef NMEA_BUFFER_MAX_LENGTH
-#define NMEA_BUFFER_MAX_LENGTH (NMEA_MESSAGE_BUFFER_MAX_LENGTH * 2)
+#define NMEA_BUFFER_MAX_LENGTH (NMEA_MESSAGE_BUFFER_MAX_LENGTH * 2 + 1)
 #endif // NMEA_BUFFER_MAX_LENGTH
 
 /**
@@ -35,9 +36,128 @@ extern "C" {
 #define NMEA_PARSER_UTILITIES 1
 #endif
 
+/**
+ * Whether it should disable the batch geodesy utility functions
+ */
+#ifndef NMEA_GEODESY
+#define NMEA_GEODESY 1
+#endif
+
+/**
+ * Whether the batch geodesy functions should use SIMD instructions (AVX, SSE2 or NEON) when available
+ * sin, cos and atan2 are then evaluated in the vector lanes with polynomial approximations, within a few ulp of the C library
+ * Disabling it uses the scalar implementation and the C library
+ */
+#ifndef NMEA_GEODESY_SIMD
+#define NMEA_GEODESY_SIMD 1
+#endif
+
+/**
+ * Whether it should disable the sentence type filter
+ */
+#ifndef NMEA_FILTER
+#define NMEA_FILTER 1
+#endif
+
+/**
+ * Whether it should disable the GSV satellite assembler
+ * Requires the parser functions
+ */
+#ifndef NMEA_GSV
+#define NMEA_GSV 1
+#endif
+
+/**
+ * Maximum amount of GSV groups (talker ID and signal ID pairs) tracked by the assembler
+ * Defaults to 8, enough for 4 constellations with 2 signals each
+ */
+#ifndef NMEA_GSV_MAX_GROUPS
+#define NMEA_GSV_MAX_GROUPS 8
+#endif
+
+/**
+ * Maximum amount of satellites stored per GSV group
+ * Satellites past this limit are ignored
+ */
+#ifndef NMEA_GSV_MAX_SATELLITES
+#define NMEA_GSV_MAX_SATELLITES 24
+#endif
+
+/**
+ * Whether it should enable the multi-receiver deduplication stage
+ * Disabled by default, as it requires a clock and a hash table
+ */
+#ifndef NMEA_DEDUP
+#define NMEA_DEDUP 0
+#endif
+
+/**
+ * Deduplication hash table size, must be a power of two
+ * Defaults to 64 entries, enough for a full epoch of sentences from 4 receivers
+ */
+#ifndef NMEA_DEDUP_TABLE_SIZE
+#define NMEA_DEDUP_TABLE_SIZE 64
+#endif
+
+/**
+ * Maximum amount of deduplication table entries inspected per message
+ * Bounds the per-message cost of the deduplication stage
+ */
+#ifndef NMEA_DEDUP_MAX_PROBES
+#define NMEA_DEDUP_MAX_PROBES 8
+#endif
+
+/**
+ * Maximum amount of sources (receivers) tracked by the best-source selection
+ */
+#ifndef NMEA_DEDUP_MAX_SOURCES
+#define NMEA_DEDUP_MAX_SOURCES 4
+#endif
+
+/**
+ * Whether it should enable the multi-threaded pipeline
+ * Disabled by default, as it requires POSIX threads
+ */
+#ifndef NMEA_PIPELINE
+#define NMEA_PIPELINE 0
+#endif
+
+/**
+ * Amount of sentences handed to a decode worker at once
+ */
+#ifndef NMEA_PIPELINE_BATCH_SIZE
+#define NMEA_PIPELINE_BATCH_SIZE 32
+#endif
+
+/**
+ * Amount of batches in flight between the framer and the delivery, must be a power of two
+ * Bounds the amount of sentences waiting to be decoded or delivered
+ */
+#ifndef NMEA_PIPELINE_QUEUE_LENGTH
+#define NMEA_PIPELINE_QUEUE_LENGTH 16
+#endif
+
+/**
+ * Maximum amount of decode workers
+ */
+#ifndef NMEA_PIPELINE_MAX_WORKERS
+#define NMEA_PIPELINE_MAX_WORKERS 8
+#endif
+
+/**
+ * Size in bytes of the result each sentence is decoded into
+ */
+#ifndef NMEA_PIPELINE_RESULT_SIZE
+#define NMEA_PIPELINE_RESULT_SIZE 64
+#endif
+
 #include <stdint.h>
 #include <stdbool.h>
 
+#if NMEA_PIPELINE
+#include <pthread.h>
+#endif
+
 /**
  * Represents a coordinate, in DMM format (Degrees and decimal minutes)
  * 
@@ -79,9 +199,70 @@ typedef enum {
 	NMEA_ERROR_BUFFER_OVERFLOW = 2
 } nmea_error_t;
 
+/**
+ * Represents how the sentence type filter treats the listed IDs
+ */
+typedef enum {
+	NMEA_FILTER_NONE = 0, // All sentences are processed
+	NMEA_FILTER_ALLOW = 1, // Only the listed sentences are processed
+	NMEA_FILTER_DENY = 2 // The listed sentences are dropped
+} nmea_filter_mode_t;
+
+/**
+ * Receives a message starting at the sentence type (e.g. "GGA,..."),
+ * the two-character talker ID is right before it, at `message - 2`
+ */
 typedef void (*nmea_process_message_t)(char *message, int length);
+
+/**
+ * Same as nmea_process_message_t, also receiving the context pointer given to `nmea_reader_init_with_context`
+ */
+typedef void (*nmea_process_message_context_t)(void *context, char *message, int length);
 typedef void (*nmea_process_error_t)(nmea_error_t error_type, char *message, int length);
 
+#if NMEA_DEDUP
+
+/**
+ * Returns a monotonic timestamp in milliseconds, wrapping around is allowed
+ */
+typedef uint32_t (*nmea_clock_t)(void);
+
+/**
+ * Represents a sentence seen by the deduplication stage
+ */
+typedef struct {
+	uint64_t hash;
+	uint32_t timestamp;
+	uint8_t checksum;
+	bool used;
+} nmea_dedup_entry_t;
+
+/**
+ * Represents the last fix quality reported by a source
+ */
+typedef struct {
+	uint32_t timestamp;
+	uint8_t rank;
+	bool used;
+} nmea_dedup_source_t;
+
+/**
+ * Represents a deduplication stage, which can be shared by multiple readers
+ */
+typedef struct {
+	nmea_dedup_entry_t entries[NMEA_DEDUP_TABLE_SIZE];
+	nmea_dedup_source_t sources[NMEA_DEDUP_MAX_SOURCES];
+	nmea_clock_t clock;
+	uint32_t window_ms;
+	bool select_source;
+	uint32_t source_timeout_ms;
+	uint8_t preferred_source;
+	uint32_t duplicates; // Amount of duplicate messages dropped
+	uint32_t rejected; // Amount of messages dropped from non-preferred sources
+} nmea_dedup_t;
+
+#endif // NMEA_DEDUP
+
 #if NMEA_BUFFER_MAX_LENGTH > 255
 typedef uint16_t nmea_buffer_index_t;
 #else
@@ -90,16 +271,34 @@ typedef uint8_t nmea_buffer_index_t;
 
 /**
  * Represents an NMEA reader instance
+ * 
+ * The buffer is a single-producer/single-consumer ring: the producer (e.g. an interrupt)
+ * only writes the head and the overflow counter, while the consumer (e.g. the main loop)
+ * owns the tail and the framing state.
  */
 typedef struct {
 	char buffer[NMEA_BUFFER_MAX_LENGTH];
 	char message[NMEA_MESSAGE_BUFFER_MAX_LENGTH];
-	nmea_buffer_index_t length;
-	nmea_buffer_index_t buffer_head; // head
-	nmea_buffer_index_t buffer_tail; // tail
-	bool buffer_dirty;
+	volatile nmea_buffer_index_t buffer_head; // head, written by the producer
+	volatile nmea_buffer_index_t buffer_tail; // tail, written by the consumer
+	volatile uint32_t buffer_overflows; // written by the producer, wide enough not to wrap between two process calls
+	volatile bool clear_requested;
+	nmea_buffer_index_t buffer_seen_head; // consumer only
+	uint32_t buffer_overflows_seen; // consumer only
 	nmea_process_message_t process_message;
+	nmea_process_message_context_t process_message_context;
+	void *context;
 	nmea_process_error_t process_error;
+#if NMEA_FILTER
+	nmea_filter_mode_t filter_mode;
+	const char *const *filter_ids;
+	uint8_t filter_count;
+	uint32_t filtered; // Amount of sentences dropped by the filter
+#endif
+#if NMEA_DEDUP
+	nmea_dedup_t *dedup;
+	uint8_t dedup_source;
+#endif
 } nmea_reader_t;
 
 /**
@@ -110,27 +309,78 @@ typedef struct {
  */
 void nmea_reader_init(nmea_reader_t *reader, nmea_process_message_t process_message);
 
+/**
+ * @brief Initializes the reader with a callback that receives a context pointer
+ * 
+ * @param reader The reader pointer
+ * @param process_message A function pointer to process nmea messages
+ * @param context A pointer forwarded to the function
+ */
+void nmea_reader_init_with_context(nmea_reader_t *reader, nmea_process_message_context_t process_message, void *context);
+
 /**
  * @brief Adds an error callback to the reader.
  * 
  * Checksum and buffer overflow errors will be fowarded to this callback.
+ * When characters were dropped because the buffer was full, the message is NULL and the length is 0,
+ * as the buffer may still be written by the producer.
  * 
  * @param reader The reader pointer
  * @param process_error The function pointer to receive errors. NULL disables the callback.
  */
 void nmea_reader_set_error_callback(nmea_reader_t *reader, nmea_process_error_t process_error);
 
+#if NMEA_FILTER
+
+/**
+ * @brief Sets a sentence type filter to the reader.
+ * 
+ * Each ID is matched against the talker ID and sentence type (e.g. "GPGSV"), and may have up to 5 characters.
+ * A "?" matches any character (e.g. "??GSV" matches GSV from any talker), and shorter IDs
+ * match as a prefix (e.g. "P" matches all proprietary sentences).
+ * 
+ * Filtered sentences are skipped as soon as their type is received: they are not copied,
+ * checksummed nor forwarded to any callback. The amount of dropped sentences is counted in `reader->filtered`.
+ * 
+ * @param reader The reader pointer
+ * @param mode Whether the IDs are allowed or denied. NMEA_FILTER_NONE disables the filter.
+ * @param ids The sentence IDs array, which must outlive the reader
+ * @param count The amount of IDs
+ */
+void nmea_reader_set_filter(nmea_reader_t *reader, nmea_filter_mode_t mode, const char *const *ids, uint8_t count);
+
+#endif // NMEA_FILTER
+
 /**
  * @brief Apprends a character to the nmea buffer
  * 
+ * Producer side: safe to call from an interrupt while another context runs `nmea_reader_process`.
+ * When the buffer is full, the character is dropped and a buffer overflow error is
+ * reported by the next `nmea_reader_process` call.
+ * 
  * @param reader The reader pointer
  * @param c The character to be appended
  */
 void nmea_reader_add_char(nmea_reader_t *reader, char c);
 
+/**
+ * @brief Apprends a block of characters to the nmea buffer
+ * 
+ * Producer side, same as `nmea_reader_add_char`, but publishes the whole block at once.
+ * Meant for DMA half-transfer and transfer-complete callbacks.
+ * Characters that don't fit in the buffer are dropped and reported as a buffer overflow.
+ * 
+ * @param reader The reader pointer
+ * @param data The characters to be appended
+ * @param length The amount of characters
+ */
+void nmea_reader_add_chars(nmea_reader_t *reader, const char *data, int length);
+
 /**
  * @brief Processes characters inside the nmea buffer trying to find messages
  * 
+ * Consumer side: all complete messages are forwarded to the callbacks, which run in the caller context.
+ * 
  * @param reader The reader pointer
  */
 void nmea_reader_process(nmea_reader_t *reader);
@@ -148,10 +398,200 @@ void nmea_reader_process_char(nmea_reader_t *reader, char c);
 /**
  * @brief Clears the nmea buffer
  * 
+ * Safe to call from either side. The buffered characters are discarded by the next
+ * `nmea_reader_process` call, along with any character appended in the meantime.
+ * 
  * @param reader The reader pointer
  */
 void nmea_reader_clear(nmea_reader_t *reader);
 
+#if NMEA_DEDUP
+
+/**
+ * @brief Initializes a deduplication stage
+ * 
+ * Identical messages seen within the time window are dropped.
+ * The window should be shorter than the receivers' update period, otherwise
+ * messages that legitimately repeat across epochs will be dropped as well.
+ * 
+ * @param dedup The deduplication stage pointer
+ * @param clock A function pointer that returns the current time in milliseconds
+ * @param window_ms The time window in milliseconds
+ */
+void nmea_dedup_init(nmea_dedup_t *dedup, nmea_clock_t clock, uint32_t window_ms);
+
+/**
+ * @brief Enables or disables the best-source selection.
+ * 
+ * When enabled, the fix quality of each source is tracked from its GGA messages,
+ * and only messages from the preferred source are accepted. The preferred source only
+ * changes when another source reports a strictly better fix, or when it hasn't reported
+ * a GGA within the timeout.
+ * The timeout should be longer than the receivers' update period (e.g. 1500ms at 1Hz),
+ * otherwise the first source to report in each epoch is preferred, whatever its fix.
+ * 
+ * @param dedup The deduplication stage pointer
+ * @param enabled Whether the selection is enabled
+ * @param timeout_ms The time after which a silent source is no longer preferred, in milliseconds
+ */
+void nmea_dedup_set_source_selection(nmea_dedup_t *dedup, bool enabled, uint32_t timeout_ms);
+
+/**
+ * @brief Checks whether a checksum-validated message should be forwarded.
+ * 
+ * Runs in constant time and does not allocate.
+ * Readers call this automatically when a deduplication stage is set.
+ * 
+ * @param dedup The deduplication stage pointer
+ * @param source The source (receiver) index, from 0 to NMEA_DEDUP_MAX_SOURCES - 1
+ * @param message The message, including the talker ID and without the "$" and checksum
+ * @param length The message length
+ * @param checksum The message checksum
+ * @return true when the message should be forwarded, false when it should be dropped
+ */
+bool nmea_dedup_accept(nmea_dedup_t *dedup, uint8_t source, const char *message, int length, uint8_t checksum);
+
+/**
+ * @brief Attaches a deduplication stage to the reader.
+ * 
+ * The same stage can be attached to multiple readers, one per receiver,
+ * as long as all of them are processed from the same thread.
+ * 
+ * @param reader The reader pointer
+ * @param dedup The deduplication stage pointer. NULL disables the stage.
+ * @param source The source (receiver) index, from 0 to NMEA_DEDUP_MAX_SOURCES - 1
+ */
+void nmea_reader_set_dedup(nmea_reader_t *reader, nmea_dedup_t *dedup, uint8_t source);
+
+#endif // NMEA_DEDUP
+
+#if NMEA_PIPELINE
+
+/**
+ * Decodes a framed sentence into a result, runs in a worker thread
+ */
+typedef void (*nmea_pipeline_decode_t)(void *context, char *message, int length, void *result);
+
+/**
+ * Receives the decoded results in the original order, runs in the thread that feeds the pipeline
+ */
+typedef void (*nmea_pipeline_deliver_t)(void *context, void *result);
+
+/**
+ * Represents a framed sentence and its decoded result
+ */
+typedef struct {
+	char message[NMEA_MESSAGE_BUFFER_MAX_LENGTH]; // Including the talker ID
+	int length;
+	union {
+		char data[NMEA_PIPELINE_RESULT_SIZE];
+		double align_double;
+		void *align_pointer;
+		uint64_t align_integer;
+	} result;
+} nmea_pipeline_sentence_t;
+
+/**
+ * Represents a batch of sentences, which is owned by a single stage at a time
+ */
+typedef struct {
+	nmea_pipeline_sentence_t sentences[NMEA_PIPELINE_BATCH_SIZE];
+	uint32_t count;
+	uint32_t state; // Phase tagged with the batch sequence, the only word used to hand the batch over
+	uint64_t enqueued_ns;
+} nmea_pipeline_batch_t;
+
+/**
+ * Represents a pipeline that frames a single stream in one thread and decodes it in multiple workers.
+ * 
+ * Filters, deduplication and the error callback can be set on the pipeline reader,
+ * they run in the thread that feeds the pipeline.
+ * Until workers are started, sentences are decoded and delivered in the thread that feeds the pipeline.
+ */
+typedef struct {
+	nmea_reader_t reader;
+	nmea_pipeline_batch_t batches[NMEA_PIPELINE_QUEUE_LENGTH];
+	nmea_pipeline_decode_t decode;
+	nmea_pipeline_deliver_t deliver;
+	void *context;
+	uint32_t write_sequence; // Batch being filled by the framer
+	uint32_t filling; // Amount of sentences in the batch being filled
+	uint32_t claim_sequence; // Next batch claimed by a worker
+	uint32_t deliver_sequence; // Next batch to be delivered
+	bool stopping;
+	int sleeping;
+	pthread_mutex_t mutex;
+	pthread_cond_t filled;
+	pthread_t workers[NMEA_PIPELINE_MAX_WORKERS];
+	int worker_count;
+	uint64_t latency_max_ns; // Maximum time between framing and delivery of a batch
+	uint64_t latency_total_ns;
+	uint32_t delivered_batches;
+} nmea_pipeline_t;
+
+/**
+ * @brief Initializes the pipeline
+ * 
+ * @param pipeline The pipeline pointer
+ * @param decode The function pointer to decode sentences, called from the workers
+ * @param deliver The function pointer to receive decoded results in order
+ * @param context A pointer forwarded to both functions
+ */
+void nmea_pipeline_init(nmea_pipeline_t *pipeline, nmea_pipeline_decode_t decode, nmea_pipeline_deliver_t deliver, void *context);
+
+/**
+ * @brief Starts the decode workers
+ * 
+ * On failure, the workers started so far are joined and the pipeline keeps decoding in the
+ * thread that feeds it, so it remains usable and starting can be retried.
+ * 
+ * @param pipeline The pipeline pointer
+ * @param workers The amount of workers, from 1 to NMEA_PIPELINE_MAX_WORKERS
+ * @return true when all workers were started, false on failure or when workers are already running
+ */
+bool nmea_pipeline_start(nmea_pipeline_t *pipeline, int workers);
+
+/**
+ * @brief Frames a block of characters and delivers the results that are ready
+ * 
+ * Sentences framed in this call are handed to the workers before it returns.
+ * Results are only delivered from the thread that feeds the pipeline, by this function,
+ * `nmea_pipeline_poll` and `nmea_pipeline_flush`. When the stream may go idle, call
+ * `nmea_pipeline_poll` periodically (e.g. when a read times out), the added latency is then
+ * bounded by the decode time of a batch plus the poll interval.
+ * Blocks while the queue is full.
+ * 
+ * @param pipeline The pipeline pointer
+ * @param data The characters
+ * @param length The amount of characters
+ */
+void nmea_pipeline_process_chars(nmea_pipeline_t *pipeline, const char *data, int length);
+
+/**
+ * @brief Delivers the results that are ready, without waiting
+ * 
+ * @param pipeline The pipeline pointer
+ */
+void nmea_pipeline_poll(nmea_pipeline_t *pipeline);
+
+/**
+ * @brief Waits until every framed sentence is decoded and delivered
+ * 
+ * @param pipeline The pipeline pointer
+ */
+void nmea_pipeline_flush(nmea_pipeline_t *pipeline);
+
+/**
+ * @brief Flushes the pipeline and stops the workers
+ * 
+ * The pipeline has to be initialized again to be reused.
+ * 
+ * @param pipeline The pipeline pointer
+ */
+void nmea_pipeline_stop(nmea_pipeline_t *pipeline);
+
+#endif // NMEA_PIPELINE
+
 #if NMEA_PARSER
 
 /**
@@ -266,6 +706,89 @@ bool nmea_read_date(char **message, nmea_date_t *date);
  */
 bool nmea_read_time(char **message, nmea_time_t *time);
 
+#if NMEA_GSV
+
+/**
+ * Represents a satellite in view, as reported by GSV messages
+ */
+typedef struct {
+	uint16_t prn;
+	uint16_t azimuth; // 0-359 degrees
+	int8_t elevation; // 0-90 degrees
+	uint8_t snr; // 0-99 dB-Hz, 0 when not tracking
+} nmea_satellite_t;
+
+/**
+ * Represents the satellites of a talker ID and signal ID pair.
+ * Parts are assembled in one bank while the other holds the last complete snapshot.
+ */
+typedef struct {
+	nmea_satellite_t satellites[2][NMEA_GSV_MAX_SATELLITES];
+	uint8_t count[2];
+	uint8_t published; // Bank holding the last complete snapshot
+	char talker[2];
+	uint8_t signal; // 0 when not reported (before NMEA 4.10)
+	uint8_t total_parts;
+	uint8_t total_satellites; // As announced by the sequence in progress
+	uint8_t next_part; // 0 when no sequence is in progress
+	bool used;
+} nmea_gsv_group_t;
+
+/**
+ * Represents a GSV assembler, which stitches multi-part GSV messages into a satellite table
+ */
+typedef struct {
+	nmea_gsv_group_t groups[NMEA_GSV_MAX_GROUPS];
+	uint32_t completed; // Amount of snapshots published
+	uint32_t dropped; // Amount of sequences discarded due to missing, out of order or inconsistent parts
+} nmea_gsv_t;
+
+/**
+ * Represents the result of processing a GSV message
+ */
+typedef enum {
+	NMEA_GSV_PENDING = 0, // The part was stored, more parts are expected
+	NMEA_GSV_COMPLETE = 1, // The last part arrived and a new snapshot was published
+	NMEA_GSV_OUT_OF_ORDER = 2, // A part is missing or out of order, the sequence was discarded
+	NMEA_GSV_INVALID = 3 // The message is malformed, the satellites don't add up to the announced total, or there is no room for a new group
+} nmea_gsv_status_t;
+
+/**
+ * @brief Initializes the GSV assembler
+ * 
+ * @param gsv The assembler pointer
+ */
+void nmea_gsv_init(nmea_gsv_t *gsv);
+
+/**
+ * @brief Processes a GSV message part
+ * 
+ * The satellites are updated in place and published only when the last part of the sequence arrives,
+ * if their amount matches the total announced by the sequence.
+ * 
+ * @param gsv The assembler pointer
+ * @param talker The two-character talker ID (e.g. "GP"), which is at `message - 2` in the message callback
+ * @param message The message pointer, right after the "GSV" field
+ * @param signal The signal ID output of the group the part belongs to, to be used with `nmea_gsv_get_satellites`. Can be NULL.
+ * @return The processing result
+ */
+nmea_gsv_status_t nmea_gsv_process(nmea_gsv_t *gsv, const char *talker, char *message, uint8_t *signal);
+
+/**
+ * @brief Gets the last complete satellite snapshot of a talker ID and signal ID pair
+ * 
+ * The snapshot stays consistent until the next sequence of the same group completes.
+ * 
+ * @param gsv The assembler pointer
+ * @param talker The two-character talker ID (e.g. "GP")
+ * @param signal The signal ID, 0 when the receiver doesn't report it
+ * @param satellites The satellites output
+ * @return The amount of satellites, 0 when none was published yet
+ */
+int nmea_gsv_get_satellites(const nmea_gsv_t *gsv, const char *talker, uint8_t signal, const nmea_satellite_t **satellites);
+
+#endif // NMEA_GSV
+
 #endif // NMEA_PARSER
 
 #if NMEA_PARSER_UTILITIES
@@ -313,6 +836,93 @@ void nmea_get_time_ms(nmea_time_t time, uint32_t *milliseconds);
 
 #endif // NMEA_PARSER_UTILITIES
 
+#if NMEA_GEODESY
+
+/**
+ * @brief Converts an array of coordinates to signed Decimal Degrees (DD).
+ * 
+ * @param coords The coordinates
+ * @param hemispheres The hemisphere of each coordinate (N/S/E/W), S and W are negative. NULL keeps all positive.
+ * @param decimal_degrees The output coordinates in decimal degrees
+ * @param count The amount of coordinates
+ */
+void nmea_get_coordinates_dd(const nmea_coordinate_t *coords, const char *hemispheres, double *decimal_degrees, int count);
+
+/**
+ * @brief Converts an array of WGS84 positions to Earth-Centered, Earth-Fixed (ECEF) coordinates.
+ * 
+ * @param latitudes The latitudes in signed decimal degrees
+ * @param longitudes The longitudes in signed decimal degrees
+ * @param altitudes The altitudes above the ellipsoid in meters. NULL uses zero.
+ * @param x The X output in meters
+ * @param y The Y output in meters
+ * @param z The Z output in meters
+ * @param count The amount of positions
+ */
+void nmea_get_ecef(const double *latitudes, const double *longitudes, const double *altitudes, double *x, double *y, double *z, int count);
+
+/**
+ * @brief Converts an array of ECEF coordinates to local East, North, Up (ENU) coordinates.
+ * 
+ * @param ref_latitude The reference latitude in signed decimal degrees
+ * @param ref_longitude The reference longitude in signed decimal degrees
+ * @param ref_altitude The reference altitude above the ellipsoid in meters
+ * @param x The ECEF X coordinates in meters
+ * @param y The ECEF Y coordinates in meters
+ * @param z The ECEF Z coordinates in meters
+ * @param east The east output in meters
+ * @param north The north output in meters
+ * @param up The up output in meters
+ * @param count The amount of coordinates
+ */
+void nmea_get_enu(double ref_latitude, double ref_longitude, double ref_altitude, const double *x, const double *y, const double *z, double *east, double *north, double *up, int count);
+
+/**
+ * @brief Calculates the great-circle (haversine) distance between consecutive positions.
+ * 
+ * @param latitudes The latitudes in signed decimal degrees
+ * @param longitudes The longitudes in signed decimal degrees
+ * @param distances The distances output in meters, with `count - 1` elements
+ * @param count The amount of positions
+ */
+void nmea_get_haversine_distances(const double *latitudes, const double *longitudes, double *distances, int count);
+
+/**
+ * @brief Calculates the equirectangular approximation of the distance between consecutive positions.
+ * 
+ * Faster than the haversine distance and accurate for positions close to each other.
+ * 
+ * @param latitudes The latitudes in signed decimal degrees
+ * @param longitudes The longitudes in signed decimal degrees
+ * @param distances The distances output in meters, with `count - 1` elements
+ * @param count The amount of positions
+ */
+void nmea_get_equirectangular_distances(const double *latitudes, const double *longitudes, double *distances, int count);
+
+/**
+ * @brief Calculates the initial bearing between consecutive positions.
+ * 
+ * @param latitudes The latitudes in signed decimal degrees
+ * @param longitudes The longitudes in signed decimal degrees
+ * @param bearings The bearings output in degrees (0-360), with `count - 1` elements
+ * @param count The amount of positions
+ */
+void nmea_get_bearings(const double *latitudes, const double *longitudes, double *bearings, int count);
+
+/**
+ * @brief Calculates the speed between consecutive positions.
+ * 
+ * Timestamps wrap around at midnight, as returned by `nmea_get_time_ms`.
+ * 
+ * @param distances The distances between consecutive positions in meters, with `count - 1` elements
+ * @param times_ms The timestamps of each position in milliseconds since the start of the day
+ * @param speeds The speeds output in meters per second, with `count - 1` elements
+ * @param count The amount of positions
+ */
+void nmea_get_speeds(const double *distances, const uint32_t *times_ms, double *speeds, int count);
+
+#endif // NMEA_GEODESY
+
 #ifdef __cplusplus
 }
 #endif
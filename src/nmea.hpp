@@ -0,0 +1,352 @@
+#ifndef _JANMEAP_NMEA_HPP_
+#define _JANMEAP_NMEA_HPP_
+
+/**
+ * Header-only C++17 field view over NMEA sentences.
+ *
+ * Fields are exposed as std::string_view slices of the original sentence, so nothing is copied or allocated.
+ * Numbers are parsed with std::from_chars, which is locale-independent and doesn't throw.
+ */
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "nmea.h"
+
+namespace nmea {
+
+/**
+ * Iterates over the comma separated fields of a sentence, stopping at the checksum delimiter
+ */
+class field_iterator {
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::string_view;
+	using difference_type = std::ptrdiff_t;
+	using pointer = const std::string_view *;
+	using reference = const std::string_view &;
+
+	/**
+	 * Creates the end iterator
+	 */
+	constexpr field_iterator() noexcept = default;
+
+	/**
+	 * Creates an iterator pointing to the first field of the sentence
+	 */
+	constexpr explicit field_iterator(std::string_view sentence) noexcept : rest_(sentence), end_(false) {
+		advance();
+	}
+
+	constexpr reference operator*() const noexcept {
+		return field_;
+	}
+
+	constexpr pointer operator->() const noexcept {
+		return &field_;
+	}
+
+	constexpr field_iterator &operator++() noexcept {
+		advance();
+		return *this;
+	}
+
+	constexpr field_iterator operator++(int) noexcept {
+		field_iterator previous = *this;
+		advance();
+		return previous;
+	}
+
+	constexpr bool operator==(const field_iterator &other) const noexcept {
+		return end_ == other.end_ && (end_ || field_.data() == other.field_.data());
+	}
+
+	constexpr bool operator!=(const field_iterator &other) const noexcept {
+		return !(*this == other);
+	}
+
+private:
+	constexpr void advance() noexcept {
+		if (last_) {
+			end_ = true;
+			field_ = std::string_view();
+			return;
+		}
+
+		std::size_t delimiter = rest_.find_first_of(",*");
+
+		if (delimiter == std::string_view::npos) {
+			field_ = rest_;
+			last_ = true;
+			return;
+		}
+
+		field_ = rest_.substr(0, delimiter);
+		last_ = rest_[delimiter] == '*';
+		rest_.remove_prefix(delimiter + 1);
+	}
+
+	std::string_view rest_;
+	std::string_view field_;
+	bool end_ = true;
+	bool last_ = false;
+};
+
+/**
+ * A lazily tokenised range of fields
+ */
+class field_range {
+public:
+	constexpr explicit field_range(std::string_view sentence) noexcept : sentence_(sentence) {}
+
+	constexpr field_iterator begin() const noexcept {
+		return field_iterator(sentence_);
+	}
+
+	constexpr field_iterator end() const noexcept {
+		return field_iterator();
+	}
+
+private:
+	std::string_view sentence_;
+};
+
+/**
+ * @brief Splits a sentence into fields, e.g. `for (auto f : nmea::fields(sv))`
+ *
+ * Accepts the messages received by the reader callback ("GGA,...") or the sentence body ("GPGGA,...").
+ * Iteration stops at the "*" checksum delimiter, if present.
+ *
+ * @param sentence The sentence
+ * @return The range of fields
+ */
+constexpr field_range fields(std::string_view sentence) noexcept {
+	return field_range(sentence);
+}
+
+/**
+ * @brief Extracts the body of a full sentence, between the "$" and the "*"
+ *
+ * @param sentence The sentence, e.g. "$GPGGA,...*47\r\n"
+ * @return The body, e.g. "GPGGA,..."
+ */
+constexpr std::string_view body(std::string_view sentence) noexcept {
+	if (!sentence.empty() && sentence.front() == '$') {
+		sentence.remove_prefix(1);
+	}
+
+	return sentence.substr(0, sentence.find('*'));
+}
+
+namespace detail {
+
+constexpr std::optional<uint8_t> read_digits(std::string_view field, std::size_t offset, std::size_t count) noexcept {
+	if (field.size() < offset + count) {
+		return std::nullopt;
+	}
+
+	unsigned value = 0;
+
+	for (std::size_t i = offset; i < offset + count; i++) {
+		char c = field[i];
+
+		if (c < '0' || c > '9') {
+			return std::nullopt;
+		}
+
+		value = value * 10 + (c - '0');
+	}
+
+	return static_cast<uint8_t>(value);
+}
+
+template <typename T>
+std::optional<T> read_float(std::string_view field) noexcept {
+	if (field.empty()) {
+		return std::nullopt;
+	}
+
+#if defined(__cpp_lib_to_chars)
+	T value;
+	auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value, std::chars_format::fixed);
+
+	if (error != std::errc() || end != field.data() + field.size()) {
+		return std::nullopt;
+	}
+
+	return value;
+#else
+	// Floating point from_chars is not available, NMEA numbers are always in the "-ddd.ddd" form
+	std::size_t i = field[0] == '-' ? 1 : 0;
+	double integer = 0, fraction = 0, scale = 1;
+	bool digits = false;
+
+	for (; i < field.size() && field[i] >= '0' && field[i] <= '9'; i++, digits = true) {
+		integer = integer * 10 + (field[i] - '0');
+	}
+
+	if (i < field.size() && field[i] == '.') {
+		for (i++; i < field.size() && field[i] >= '0' && field[i] <= '9'; i++, digits = true) {
+			fraction = fraction * 10 + (field[i] - '0');
+			scale *= 10;
+		}
+	}
+
+	if (!digits || i != field.size()) {
+		return std::nullopt;
+	}
+
+	double value = integer + fraction / scale;
+	return static_cast<T>(field[0] == '-' ? -value : value);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief Reads an integer field
+ *
+ * @param field The field
+ * @return The number, or nothing when the field is empty, malformed or out of range
+ */
+template <typename T = uint32_t>
+std::optional<T> to_int(std::string_view field) noexcept {
+	static_assert(std::is_integral_v<T>, "to_int requires an integer type");
+
+	if (field.empty()) {
+		return std::nullopt;
+	}
+
+	T value;
+	auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), value);
+
+	if (error != std::errc() || end != field.data() + field.size()) {
+		return std::nullopt;
+	}
+
+	return value;
+}
+
+/**
+ * @brief Reads a floating point field
+ *
+ * @param field The field
+ * @return The number, or nothing when the field is empty or malformed
+ */
+template <typename T = float>
+std::optional<T> to_float(std::string_view field) noexcept {
+	static_assert(std::is_floating_point_v<T>, "to_float requires a floating point type");
+	return detail::read_float<T>(field);
+}
+
+/**
+ * @brief Reads a single character field
+ *
+ * @param field The field
+ * @return The character, or nothing when the field is empty
+ */
+constexpr std::optional<char> to_char(std::string_view field) noexcept {
+	if (field.empty()) {
+		return std::nullopt;
+	}
+
+	return field.front();
+}
+
+/**
+ * @brief Reads a latitude/longitude coordinate in "ddmm.mm" or "dddmm.mm"
+ *
+ * @param field The field
+ * @param deg_3_digits true if the format is "dddmm.mm", false if the format is "ddmm.mm"
+ * @return The coordinate, or nothing when the field is empty or malformed
+ */
+inline std::optional<nmea_coordinate_t> to_coordinate(std::string_view field, bool deg_3_digits) noexcept {
+	std::size_t digits = deg_3_digits ? 3 : 2;
+	std::optional<uint8_t> degrees = detail::read_digits(field, 0, digits);
+
+	if (!degrees) {
+		return std::nullopt;
+	}
+
+	std::optional<double> minutes = detail::read_float<double>(field.substr(digits));
+
+	if (!minutes) {
+		return std::nullopt;
+	}
+
+	nmea_coordinate_t coord;
+	coord.degrees = *degrees;
+	coord.decimal_minutes = *minutes;
+	return coord;
+}
+
+/**
+ * @brief Reads a latitude coordinate in "ddmm.mm"
+ *
+ * @param field The field
+ * @return The coordinate, or nothing when the field is empty or malformed
+ */
+inline std::optional<nmea_coordinate_t> to_latitude(std::string_view field) noexcept {
+	return to_coordinate(field, false);
+}
+
+/**
+ * @brief Reads a longitude coordinate in "dddmm.mm"
+ *
+ * @param field The field
+ * @return The coordinate, or nothing when the field is empty or malformed
+ */
+inline std::optional<nmea_coordinate_t> to_longitude(std::string_view field) noexcept {
+	return to_coordinate(field, true);
+}
+
+/**
+ * @brief Reads a date in "ddmmyy"
+ *
+ * @param field The field
+ * @return The date, or nothing when the field is empty or malformed
+ */
+constexpr std::optional<nmea_date_t> to_date(std::string_view field) noexcept {
+	std::optional<uint8_t> date = detail::read_digits(field, 0, 2);
+	std::optional<uint8_t> month = detail::read_digits(field, 2, 2);
+	std::optional<uint8_t> year = detail::read_digits(field, 4, 2);
+
+	if (field.size() != 6 || !date || !month || !year) {
+		return std::nullopt;
+	}
+
+	return nmea_date_t { *date, *month, *year };
+}
+
+/**
+ * @brief Reads a time in "hhmmss.ss"
+ *
+ * @param field The field
+ * @return The time, or nothing when the field is empty or malformed
+ */
+inline std::optional<nmea_time_t> to_time(std::string_view field) noexcept {
+	std::optional<uint8_t> hours = detail::read_digits(field, 0, 2);
+	std::optional<uint8_t> minutes = detail::read_digits(field, 2, 2);
+
+	if (!hours || !minutes) {
+		return std::nullopt;
+	}
+
+	std::optional<float> seconds = detail::read_float<float>(field.substr(4));
+
+	if (!seconds) {
+		return std::nullopt;
+	}
+
+	return nmea_time_t { *hours, *minutes, *seconds };
+}
+
+} // namespace nmea
+
+#endif // _JANMEAP_NMEA_HPP_
@@ -0,0 +1,210 @@
+#include "nmea.h"
+
+#if NMEA_DEDUP
+
+#include <string.h>
+
+#define NMEA_DEDUP_NO_SOURCE 0xFF
+
+#if (NMEA_DEDUP_TABLE_SIZE & (NMEA_DEDUP_TABLE_SIZE - 1)) != 0
+#error "NMEA_DEDUP_TABLE_SIZE must be a power of two"
+#endif
+
+// GGA quality indicator (0-8) ranked from worst to best fix
+// 0 = invalid, 8 = simulation, 7 = manual, 6 = estimated, 1 = GPS, 2 = DGPS and 3 = PPS (tied), 5 = RTK float, 4 = RTK fixed
+static const uint8_t nmea_dedup_quality_rank[] = { 0, 4, 5, 5, 7, 6, 3, 2, 1 };
+
+void nmea_dedup_init(nmea_dedup_t *dedup, nmea_clock_t clock, uint32_t window_ms) {
+	memset(dedup->entries, 0, sizeof(dedup->entries));
+	memset(dedup->sources, 0, sizeof(dedup->sources));
+	dedup->clock = clock;
+	dedup->window_ms = window_ms;
+	dedup->select_source = false;
+	dedup->source_timeout_ms = 0;
+	dedup->preferred_source = NMEA_DEDUP_NO_SOURCE;
+	dedup->duplicates = 0;
+	dedup->rejected = 0;
+}
+
+void nmea_dedup_set_source_selection(nmea_dedup_t *dedup, bool enabled, uint32_t timeout_ms) {
+	dedup->select_source = enabled;
+	dedup->source_timeout_ms = timeout_ms;
+	dedup->preferred_source = NMEA_DEDUP_NO_SOURCE;
+}
+
+static inline bool nmea_dedup_is_recent(nmea_dedup_t *dedup, uint32_t timestamp, uint32_t now) {
+	return (uint32_t)(now - timestamp) < dedup->window_ms;
+}
+
+// wyhash constants
+#define NMEA_DEDUP_SECRET0 0xa0761d6478bd642fULL
+#define NMEA_DEDUP_SECRET1 0xe7037ed1a0b428dbULL
+
+static inline uint64_t nmea_dedup_read64(const char *p) {
+	// memcpy compiles to a single unaligned load
+	uint64_t value;
+	memcpy(&value, p, sizeof(value));
+	return value;
+}
+
+static inline uint64_t nmea_dedup_mix(uint64_t a, uint64_t b) {
+	// Folds the 128-bit product of a and b into 64 bits
+#if defined(__SIZEOF_INT128__)
+	__uint128_t r = (__uint128_t) a * b;
+	return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+	uint64_t ha = a >> 32, la = (uint32_t) a, hb = b >> 32, lb = (uint32_t) b;
+	uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+	uint64_t t = rl + (rm0 << 32), carry = t < rl;
+	uint64_t lo = t + (rm1 << 32);
+	carry += lo < t;
+	uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+	return lo ^ hi;
+#endif
+}
+
+static uint64_t nmea_dedup_hash(const char *message, int length) {
+	// wyhash-style, a single multiplication for every 16 bytes
+	uint64_t seed = NMEA_DEDUP_SECRET0 ^ (uint64_t) length;
+
+	for (int i = 0; i + 16 <= length; i += 16) {
+		seed = nmea_dedup_mix(nmea_dedup_read64(message + i) ^ NMEA_DEDUP_SECRET1, nmea_dedup_read64(message + i + 8) ^ seed);
+	}
+
+	uint64_t a = 0, b = 0;
+
+	if (length >= 16) {
+		// The last 16 bytes, overlapping the ones already mixed
+		a = nmea_dedup_read64(message + length - 16);
+		b = nmea_dedup_read64(message + length - 8);
+	} else if (length > 8) {
+		a = nmea_dedup_read64(message);
+		memcpy(&b, message + 8, length - 8);
+	} else {
+		memcpy(&a, message, length);
+	}
+
+	return nmea_dedup_mix(NMEA_DEDUP_SECRET1 ^ (uint64_t) length, nmea_dedup_mix(a ^ NMEA_DEDUP_SECRET1, b ^ seed));
+}
+
+static bool nmea_dedup_is_duplicate(nmea_dedup_t *dedup, const char *message, int length, uint8_t checksum, uint32_t now) {
+	uint64_t hash = nmea_dedup_hash(message, length);
+	nmea_dedup_entry_t *slot = NULL;
+	bool slot_free = false;
+
+	// Linear probing over a bounded amount of entries, expired entries are reused
+	for (int i = 0; i < NMEA_DEDUP_MAX_PROBES; i++) {
+		nmea_dedup_entry_t *entry = &dedup->entries[(hash + i) & (NMEA_DEDUP_TABLE_SIZE - 1)];
+
+		if (!entry->used || !nmea_dedup_is_recent(dedup, entry->timestamp, now)) {
+			if (!slot_free) {
+				slot = entry;
+				slot_free = true;
+			}
+
+			if (!entry->used) {
+				// Nothing was ever inserted past this point
+				break;
+			}
+
+			continue;
+		}
+
+		if (entry->hash == hash && entry->checksum == checksum) {
+			return true;
+		}
+
+		if (slot == NULL || (!slot_free && (uint32_t)(now - entry->timestamp) > (uint32_t)(now - slot->timestamp))) {
+			// Keeps track of the oldest entry in case every probed entry is still recent
+			slot = entry;
+		}
+	}
+
+	slot->hash = hash;
+	slot->checksum = checksum;
+	slot->timestamp = now;
+	slot->used = true;
+
+	return false;
+}
+
+static int nmea_dedup_read_quality(const char *message, int length) {
+	// GNGGA,hhmmss.ss,ddmm.mm,N,dddmm.mm,W,q,...
+	if (length < 5 || memcmp(message + 2, "GGA", 3) != 0) {
+		return -1;
+	}
+
+	int fields = 0;
+
+	for (int i = 5; i < length; i++) {
+		if (message[i] != ',') {
+			continue;
+		}
+
+		if (++fields == 6) {
+			char c = i + 1 < length ? message[i + 1] : ',';
+			return c >= '0' && c <= '8' ? c - '0' : 0;
+		}
+	}
+
+	return -1;
+}
+
+static inline bool nmea_dedup_is_alive(nmea_dedup_t *dedup, uint8_t source, uint32_t now) {
+	return (uint32_t)(now - dedup->sources[source].timestamp) < dedup->source_timeout_ms;
+}
+
+static void nmea_dedup_select_source(nmea_dedup_t *dedup, uint8_t source, int quality, uint32_t now) {
+	nmea_dedup_source_t *src = &dedup->sources[source];
+	src->rank = nmea_dedup_quality_rank[quality];
+	src->timestamp = now;
+	src->used = true;
+
+	uint8_t preferred = dedup->preferred_source;
+
+	if (preferred == NMEA_DEDUP_NO_SOURCE || !nmea_dedup_is_alive(dedup, preferred, now) ||
+		src->rank > dedup->sources[preferred].rank) {
+		// Only a strictly better fix or a timed out source changes the preferred one
+		dedup->preferred_source = source;
+		return;
+	}
+
+	if (preferred != source) {
+		return;
+	}
+
+	// The preferred source reported again, another live source may be better now
+	for (uint8_t i = 0; i < NMEA_DEDUP_MAX_SOURCES; i++) {
+		nmea_dedup_source_t *other = &dedup->sources[i];
+
+		if (other->used && other->rank > dedup->sources[dedup->preferred_source].rank && nmea_dedup_is_alive(dedup, i, now)) {
+			dedup->preferred_source = i;
+		}
+	}
+}
+
+bool nmea_dedup_accept(nmea_dedup_t *dedup, uint8_t source, const char *message, int length, uint8_t checksum) {
+	uint32_t now = dedup->clock();
+
+	if (dedup->select_source && source < NMEA_DEDUP_MAX_SOURCES) {
+		int quality = nmea_dedup_read_quality(message, length);
+
+		if (quality >= 0) {
+			nmea_dedup_select_source(dedup, source, quality, now);
+		}
+
+		if (dedup->preferred_source != NMEA_DEDUP_NO_SOURCE && dedup->preferred_source != source) {
+			dedup->rejected++;
+			return false;
+		}
+	}
+
+	if (nmea_dedup_is_duplicate(dedup, message, length, checksum, now)) {
+		dedup->duplicates++;
+		return false;
+	}
+
+	return true;
+}
+
+#endif // NMEA_DEDUP
@@ -0,0 +1,422 @@
+#include "nmea.h"
+
+#if NMEA_GEODESY
+
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+
+#if NMEA_GEODESY_SIMD && defined(__AVX__)
+#include <immintrin.h>
+#define NMEA_LANES 4
+typedef __m256d nmea_vec_t;
+typedef __m256d nmea_mask_t;
+#define nmea_vec_load(ptr) _mm256_loadu_pd(ptr)
+#define nmea_vec_store(ptr, v) _mm256_storeu_pd(ptr, v)
+#define nmea_vec_splat(x) _mm256_set1_pd(x)
+#define nmea_vec_add(a, b) _mm256_add_pd(a, b)
+#define nmea_vec_sub(a, b) _mm256_sub_pd(a, b)
+#define nmea_vec_mul(a, b) _mm256_mul_pd(a, b)
+#define nmea_vec_div(a, b) _mm256_div_pd(a, b)
+#define nmea_vec_sqrt(a) _mm256_sqrt_pd(a)
+#define nmea_vec_min(a, b) _mm256_min_pd(a, b)
+#define nmea_vec_max(a, b) _mm256_max_pd(a, b)
+#define nmea_vec_abs(a) _mm256_andnot_pd(_mm256_set1_pd(-0.0), a)
+#define nmea_vec_lt(a, b) _mm256_cmp_pd(a, b, _CMP_LT_OQ)
+#define nmea_vec_select(mask, a, b) _mm256_blendv_pd(b, a, mask)
+#elif NMEA_GEODESY_SIMD && defined(__SSE2__)
+#include <emmintrin.h>
+#define NMEA_LANES 2
+typedef __m128d nmea_vec_t;
+typedef __m128d nmea_mask_t;
+#define nmea_vec_load(ptr) _mm_loadu_pd(ptr)
+#define nmea_vec_store(ptr, v) _mm_storeu_pd(ptr, v)
+#define nmea_vec_splat(x) _mm_set1_pd(x)
+#define nmea_vec_add(a, b) _mm_add_pd(a, b)
+#define nmea_vec_sub(a, b) _mm_sub_pd(a, b)
+#define nmea_vec_mul(a, b) _mm_mul_pd(a, b)
+#define nmea_vec_div(a, b) _mm_div_pd(a, b)
+#define nmea_vec_sqrt(a) _mm_sqrt_pd(a)
+#define nmea_vec_min(a, b) _mm_min_pd(a, b)
+#define nmea_vec_max(a, b) _mm_max_pd(a, b)
+#define nmea_vec_abs(a) _mm_andnot_pd(_mm_set1_pd(-0.0), a)
+#define nmea_vec_lt(a, b) _mm_cmplt_pd(a, b)
+#define nmea_vec_select(mask, a, b) _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b))
+#elif NMEA_GEODESY_SIMD && defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define NMEA_LANES 2
+typedef float64x2_t nmea_vec_t;
+typedef uint64x2_t nmea_mask_t;
+#define nmea_vec_load(ptr) vld1q_f64(ptr)
+#define nmea_vec_store(ptr, v) vst1q_f64(ptr, v)
+#define nmea_vec_splat(x) vdupq_n_f64(x)
+#define nmea_vec_add(a, b) vaddq_f64(a, b)
+#define nmea_vec_sub(a, b) vsubq_f64(a, b)
+#define nmea_vec_mul(a, b) vmulq_f64(a, b)
+#define nmea_vec_div(a, b) vdivq_f64(a, b)
+#define nmea_vec_sqrt(a) vsqrtq_f64(a)
+#define nmea_vec_min(a, b) vminq_f64(a, b)
+#define nmea_vec_max(a, b) vmaxq_f64(a, b)
+#define nmea_vec_abs(a) vabsq_f64(a)
+#define nmea_vec_lt(a, b) vcltq_f64(a, b)
+#define nmea_vec_select(mask, a, b) vbslq_f64(mask, a, b)
+#else
+// Scalar fallback, a single lane
+#define NMEA_LANES 1
+typedef double nmea_vec_t;
+#define nmea_vec_load(ptr) (*(ptr))
+#define nmea_vec_store(ptr, v) (*(ptr) = (v))
+#define nmea_vec_splat(x) (x)
+#define nmea_vec_add(a, b) ((a) + (b))
+#define nmea_vec_sub(a, b) ((a) - (b))
+#define nmea_vec_mul(a, b) ((a) * (b))
+#define nmea_vec_div(a, b) ((a) / (b))
+#define nmea_vec_sqrt(a) sqrt(a)
+#endif
+
+#define NMEA_PI 3.14159265358979323846
+#define NMEA_DEG_TO_RAD (NMEA_PI / 180.0)
+#define NMEA_RAD_TO_DEG (180.0 / NMEA_PI)
+#define NMEA_DAY_MS 86400000
+
+// WGS84 ellipsoid
+#define NMEA_WGS84_A 6378137.0
+#define NMEA_WGS84_F (1.0 / 298.257223563)
+#define NMEA_WGS84_E2 (NMEA_WGS84_F * (2.0 - NMEA_WGS84_F))
+
+// IUGG mean Earth radius, used by the spherical approximations
+#define NMEA_EARTH_RADIUS 6371008.8
+
+#if NMEA_LANES > 1
+
+// Adding and subtracting 1.5 * 2^52 rounds to the nearest even integer, valid below 2^51
+#define NMEA_ROUND_MAGIC 6755399441055744.0
+
+// pi/2 split in three parts, the first two are exact when multiplied by small integers (Cephes)
+#define NMEA_PI_2_A 1.57079625129699707031e+00
+#define NMEA_PI_2_B 7.54978941586159635335e-08
+#define NMEA_PI_2_C 5.39030285815811905290e-15
+
+// The low bits of pi/4, restores the precision lost by rounding pi/4 (Cephes)
+#define NMEA_PI_4_LOW 3.061616997868382943065e-17
+
+static inline nmea_vec_t nmea_vec_round(nmea_vec_t a) {
+	nmea_vec_t magic = nmea_vec_splat(NMEA_ROUND_MAGIC);
+	return nmea_vec_sub(nmea_vec_add(a, magic), magic);
+}
+
+// a * b + c
+#define nmea_vec_madd(a, b, c) nmea_vec_add(nmea_vec_mul(a, b), c)
+
+// Horner's method, highest degree first. Unrolled, as the compiler doesn't always do it at -O2
+static inline nmea_vec_t nmea_vec_polynomial5(nmea_vec_t x, const double *c) {
+	nmea_vec_t result = nmea_vec_madd(nmea_vec_splat(c[0]), x, nmea_vec_splat(c[1]));
+	result = nmea_vec_madd(result, x, nmea_vec_splat(c[2]));
+	result = nmea_vec_madd(result, x, nmea_vec_splat(c[3]));
+	return nmea_vec_madd(result, x, nmea_vec_splat(c[4]));
+}
+
+static inline nmea_vec_t nmea_vec_polynomial6(nmea_vec_t x, const double *c) {
+	return nmea_vec_madd(nmea_vec_polynomial5(x, c), x, nmea_vec_splat(c[5]));
+}
+
+// Minimax polynomials over [-pi/4, pi/4] (Cephes)
+static const double nmea_sin_coefficients[] = {
+	1.58962301576546568060e-10, -2.50507477628578072866e-8, 2.75573136213857245213e-6,
+	-1.98412698295895385996e-4, 8.33333333332211858878e-3, -1.66666666666666307295e-1
+};
+
+static const double nmea_cos_coefficients[] = {
+	-1.13585365213876817300e-11, 2.08757008419747316778e-9, -2.75573141792967388112e-7,
+	2.48015872888517045348e-5, -1.38888888888730564116e-3, 4.16666666666665929218e-2
+};
+
+static inline void nmea_vec_sincos(nmea_vec_t x, nmea_vec_t *sin_x, nmea_vec_t *cos_x) {
+	// x = r + q * pi/2, with r in [-pi/4, pi/4]
+	nmea_vec_t q = nmea_vec_round(nmea_vec_mul(x, nmea_vec_splat(2.0 / NMEA_PI)));
+	nmea_vec_t r = nmea_vec_sub(x, nmea_vec_mul(q, nmea_vec_splat(NMEA_PI_2_A)));
+	r = nmea_vec_sub(r, nmea_vec_mul(q, nmea_vec_splat(NMEA_PI_2_B)));
+	r = nmea_vec_sub(r, nmea_vec_mul(q, nmea_vec_splat(NMEA_PI_2_C)));
+
+	nmea_vec_t z = nmea_vec_mul(r, r);
+	nmea_vec_t sin_r = nmea_vec_add(r, nmea_vec_mul(nmea_vec_mul(r, z), nmea_vec_polynomial6(z, nmea_sin_coefficients)));
+	nmea_vec_t cos_r = nmea_vec_add(nmea_vec_sub(nmea_vec_splat(1.0), nmea_vec_mul(nmea_vec_splat(0.5), z)),
+		nmea_vec_mul(nmea_vec_mul(z, z), nmea_vec_polynomial6(z, nmea_cos_coefficients)));
+
+	// The quadrant (q mod 4) picks and negates sin(r) or cos(r), as 0 or 1 factors so that the lanes don't branch
+	nmea_vec_t one = nmea_vec_splat(1.0);
+	nmea_vec_t two = nmea_vec_splat(2.0);
+	nmea_vec_t quadrant = nmea_vec_sub(q, nmea_vec_mul(nmea_vec_splat(4.0), nmea_vec_round(nmea_vec_sub(nmea_vec_mul(q, nmea_vec_splat(0.25)), nmea_vec_splat(0.375)))));
+	nmea_vec_t upper = nmea_vec_round(nmea_vec_sub(nmea_vec_mul(quadrant, nmea_vec_splat(0.5)), nmea_vec_splat(0.25))); // Quadrants 2 and 3
+	nmea_vec_t odd = nmea_vec_sub(quadrant, nmea_vec_mul(two, upper)); // Quadrants 1 and 3
+	nmea_vec_t even = nmea_vec_sub(one, odd);
+
+	// sin is negative in quadrants 2 and 3, cos in quadrants 1 and 2
+	nmea_vec_t sin_sign = nmea_vec_sub(one, nmea_vec_mul(two, upper));
+	nmea_vec_t cos_sign = nmea_vec_sub(one, nmea_vec_mul(two, nmea_vec_sub(nmea_vec_add(upper, odd), nmea_vec_mul(two, nmea_vec_mul(upper, odd)))));
+
+	*sin_x = nmea_vec_mul(sin_sign, nmea_vec_add(nmea_vec_mul(sin_r, even), nmea_vec_mul(cos_r, odd)));
+	*cos_x = nmea_vec_mul(cos_sign, nmea_vec_add(nmea_vec_mul(cos_r, even), nmea_vec_mul(sin_r, odd)));
+}
+
+// Rational approximation of atan over [-0.66, 0.66] (Cephes)
+static const double nmea_atan_p[] = {
+	-8.750608600031904122785e-1, -1.615753718733365076637e1, -7.500855792314704667340e1,
+	-1.228866684490136173410e2, -6.485021904942025371773e1
+};
+
+static const double nmea_atan_q[] = {
+	1.0, 2.485846490142306297962e1, 1.650270098316988542046e2,
+	4.328810604912902668951e2, 4.853903996359136964868e2, 1.945506571482613964425e2
+};
+
+static inline nmea_vec_t nmea_vec_atan2(nmea_vec_t y, nmea_vec_t x) {
+	nmea_vec_t zero = nmea_vec_splat(0.0);
+	nmea_vec_t one = nmea_vec_splat(1.0);
+	nmea_vec_t ax = nmea_vec_abs(x);
+	nmea_vec_t ay = nmea_vec_abs(y);
+
+	// atan of the ratio in [0, 1], zero when both are zero
+	nmea_vec_t t = nmea_vec_div(nmea_vec_min(ax, ay), nmea_vec_max(nmea_vec_max(ax, ay), nmea_vec_splat(DBL_MIN)));
+
+	// atan(t) = pi/4 + atan((t - 1) / (t + 1)) above 0.66
+	nmea_mask_t reduced = nmea_vec_lt(nmea_vec_splat(0.66), t);
+	nmea_vec_t u = nmea_vec_select(reduced, nmea_vec_div(nmea_vec_sub(t, one), nmea_vec_add(t, one)), t);
+	nmea_vec_t base = nmea_vec_select(reduced, nmea_vec_splat(NMEA_PI / 4.0), zero);
+	nmea_vec_t low = nmea_vec_select(reduced, nmea_vec_splat(NMEA_PI_4_LOW), zero);
+
+	nmea_vec_t z = nmea_vec_mul(u, u);
+	nmea_vec_t p = nmea_vec_div(nmea_vec_polynomial5(z, nmea_atan_p), nmea_vec_polynomial6(z, nmea_atan_q));
+	nmea_vec_t r = nmea_vec_add(base, nmea_vec_add(u, nmea_vec_add(nmea_vec_mul(nmea_vec_mul(u, z), p), low)));
+
+	// Back to the original octant and quadrant
+	r = nmea_vec_select(nmea_vec_lt(ax, ay), nmea_vec_sub(nmea_vec_splat(NMEA_PI / 2.0), r), r);
+	r = nmea_vec_select(nmea_vec_lt(x, zero), nmea_vec_sub(nmea_vec_splat(NMEA_PI), r), r);
+	return nmea_vec_select(nmea_vec_lt(y, zero), nmea_vec_sub(zero, r), r);
+}
+
+#else
+
+// A single lane uses the C library
+#define nmea_vec_round(a) rint(a)
+#define nmea_vec_atan2(y, x) atan2(y, x)
+#define nmea_vec_select(mask, a, b) ((mask) ? (a) : (b))
+#define nmea_vec_lt(a, b) ((a) < (b))
+
+static inline void nmea_vec_sincos(double x, double *sin_x, double *cos_x) {
+	*sin_x = sin(x);
+	*cos_x = cos(x);
+}
+
+#endif // NMEA_LANES > 1
+
+void nmea_get_coordinates_dd(const nmea_coordinate_t *coords, const char *hemispheres, double *decimal_degrees, int count) {
+	// A branch-free loop over the array of structs, left to the compiler, as gathering the fields into lanes costs more than the arithmetic
+	for (int i = 0; i < count; i++) {
+		decimal_degrees[i] = coords[i].degrees + coords[i].decimal_minutes / 60.0;
+	}
+
+	if (hemispheres == NULL) {
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		bool negative = (hemispheres[i] == 'S') | (hemispheres[i] == 'W');
+		decimal_degrees[i] *= 1.0 - 2.0 * negative;
+	}
+}
+
+void nmea_get_ecef(const double *latitudes, const double *longitudes, const double *altitudes, double *x, double *y, double *z, int count) {
+	int i = 0;
+
+	nmea_vec_t one = nmea_vec_splat(1.0);
+	nmea_vec_t zero = nmea_vec_splat(0.0);
+	nmea_vec_t deg_to_rad = nmea_vec_splat(NMEA_DEG_TO_RAD);
+	nmea_vec_t a = nmea_vec_splat(NMEA_WGS84_A);
+	nmea_vec_t e2 = nmea_vec_splat(NMEA_WGS84_E2);
+	nmea_vec_t one_minus_e2 = nmea_vec_splat(1.0 - NMEA_WGS84_E2);
+
+	for (; i + NMEA_LANES <= count; i += NMEA_LANES) {
+		nmea_vec_t sin_lat, cos_lat, sin_lon, cos_lon;
+		nmea_vec_sincos(nmea_vec_mul(nmea_vec_load(latitudes + i), deg_to_rad), &sin_lat, &cos_lat);
+		nmea_vec_sincos(nmea_vec_mul(nmea_vec_load(longitudes + i), deg_to_rad), &sin_lon, &cos_lon);
+
+		nmea_vec_t alt = altitudes != NULL ? nmea_vec_load(altitudes + i) : zero;
+
+		// Prime vertical radius of curvature
+		nmea_vec_t n = nmea_vec_div(a, nmea_vec_sqrt(nmea_vec_sub(one, nmea_vec_mul(e2, nmea_vec_mul(sin_lat, sin_lat)))));
+		nmea_vec_t r = nmea_vec_mul(nmea_vec_add(n, alt), cos_lat);
+
+		nmea_vec_store(x + i, nmea_vec_mul(r, cos_lon));
+		nmea_vec_store(y + i, nmea_vec_mul(r, sin_lon));
+		nmea_vec_store(z + i, nmea_vec_mul(nmea_vec_add(nmea_vec_mul(n, one_minus_e2), alt), sin_lat));
+	}
+
+	for (; i < count; i++) {
+		double sin_lat = sin(latitudes[i] * NMEA_DEG_TO_RAD);
+		double cos_lat = cos(latitudes[i] * NMEA_DEG_TO_RAD);
+		double alt = altitudes != NULL ? altitudes[i] : 0.0;
+		double n = NMEA_WGS84_A / sqrt(1.0 - NMEA_WGS84_E2 * (sin_lat * sin_lat));
+
+		x[i] = ((n + alt) * cos_lat) * cos(longitudes[i] * NMEA_DEG_TO_RAD);
+		y[i] = ((n + alt) * cos_lat) * sin(longitudes[i] * NMEA_DEG_TO_RAD);
+		z[i] = (n * (1.0 - NMEA_WGS84_E2) + alt) * sin_lat;
+	}
+}
+
+void nmea_get_enu(double ref_latitude, double ref_longitude, double ref_altitude, const double *x, const double *y, const double *z, double *east, double *north, double *up, int count) {
+	double x0, y0, z0;
+	nmea_get_ecef(&ref_latitude, &ref_longitude, &ref_altitude, &x0, &y0, &z0, 1);
+
+	double sin_lat = sin(ref_latitude * NMEA_DEG_TO_RAD);
+	double cos_lat = cos(ref_latitude * NMEA_DEG_TO_RAD);
+	double sin_lon = sin(ref_longitude * NMEA_DEG_TO_RAD);
+	double cos_lon = cos(ref_longitude * NMEA_DEG_TO_RAD);
+
+	// Rotation from ECEF to the local tangent plane
+	double e_x = -sin_lon, e_y = cos_lon;
+	double n_x = -sin_lat * cos_lon, n_y = -sin_lat * sin_lon, n_z = cos_lat;
+	double u_x = cos_lat * cos_lon, u_y = cos_lat * sin_lon, u_z = sin_lat;
+
+	int i = 0;
+
+	for (; i + NMEA_LANES <= count; i += NMEA_LANES) {
+		nmea_vec_t dx = nmea_vec_sub(nmea_vec_load(x + i), nmea_vec_splat(x0));
+		nmea_vec_t dy = nmea_vec_sub(nmea_vec_load(y + i), nmea_vec_splat(y0));
+		nmea_vec_t dz = nmea_vec_sub(nmea_vec_load(z + i), nmea_vec_splat(z0));
+
+		nmea_vec_store(east + i, nmea_vec_add(nmea_vec_mul(nmea_vec_splat(e_x), dx), nmea_vec_mul(nmea_vec_splat(e_y), dy)));
+		nmea_vec_store(north + i, nmea_vec_add(nmea_vec_add(nmea_vec_mul(nmea_vec_splat(n_x), dx), nmea_vec_mul(nmea_vec_splat(n_y), dy)), nmea_vec_mul(nmea_vec_splat(n_z), dz)));
+		nmea_vec_store(up + i, nmea_vec_add(nmea_vec_add(nmea_vec_mul(nmea_vec_splat(u_x), dx), nmea_vec_mul(nmea_vec_splat(u_y), dy)), nmea_vec_mul(nmea_vec_splat(u_z), dz)));
+	}
+
+	for (; i < count; i++) {
+		double dx = x[i] - x0, dy = y[i] - y0, dz = z[i] - z0;
+
+		east[i] = e_x * dx + e_y * dy;
+		north[i] = (n_x * dx + n_y * dy) + n_z * dz;
+		up[i] = (u_x * dx + u_y * dy) + u_z * dz;
+	}
+}
+
+void nmea_get_haversine_distances(const double *latitudes, const double *longitudes, double *distances, int count) {
+	int pairs = count - 1;
+	int i = 0;
+
+	nmea_vec_t one = nmea_vec_splat(1.0);
+	nmea_vec_t half_deg_to_rad = nmea_vec_splat(NMEA_DEG_TO_RAD * 0.5);
+	nmea_vec_t deg_to_rad = nmea_vec_splat(NMEA_DEG_TO_RAD);
+	nmea_vec_t diameter = nmea_vec_splat(2.0 * NMEA_EARTH_RADIUS);
+
+	for (; i + NMEA_LANES <= pairs; i += NMEA_LANES) {
+		nmea_vec_t lat1 = nmea_vec_load(latitudes + i);
+		nmea_vec_t lat2 = nmea_vec_load(latitudes + i + 1);
+		nmea_vec_t dlon = nmea_vec_sub(nmea_vec_load(longitudes + i + 1), nmea_vec_load(longitudes + i));
+
+		nmea_vec_t sin_dlat, sin_dlon, sin_lat1, cos_lat1, sin_lat2, cos_lat2, unused;
+		nmea_vec_sincos(nmea_vec_mul(nmea_vec_sub(lat2, lat1), half_deg_to_rad), &sin_dlat, &unused);
+		nmea_vec_sincos(nmea_vec_mul(dlon, half_deg_to_rad), &sin_dlon, &unused);
+		nmea_vec_sincos(nmea_vec_mul(lat1, deg_to_rad), &sin_lat1, &cos_lat1);
+		nmea_vec_sincos(nmea_vec_mul(lat2, deg_to_rad), &sin_lat2, &cos_lat2);
+
+		nmea_vec_t a = nmea_vec_add(nmea_vec_mul(sin_dlat, sin_dlat), nmea_vec_mul(nmea_vec_mul(cos_lat1, cos_lat2), nmea_vec_mul(sin_dlon, sin_dlon)));
+		nmea_vec_store(distances + i, nmea_vec_mul(diameter, nmea_vec_atan2(nmea_vec_sqrt(a), nmea_vec_sqrt(nmea_vec_sub(one, a)))));
+	}
+
+	for (; i < pairs; i++) {
+		double lat1 = latitudes[i] * NMEA_DEG_TO_RAD;
+		double lat2 = latitudes[i + 1] * NMEA_DEG_TO_RAD;
+		double sin_dlat = sin((lat2 - lat1) * 0.5);
+		double sin_dlon = sin((longitudes[i + 1] - longitudes[i]) * NMEA_DEG_TO_RAD * 0.5);
+
+		double a = sin_dlat * sin_dlat + cos(lat1) * cos(lat2) * (sin_dlon * sin_dlon);
+		distances[i] = 2.0 * NMEA_EARTH_RADIUS * atan2(sqrt(a), sqrt(1.0 - a));
+	}
+}
+
+void nmea_get_equirectangular_distances(const double *latitudes, const double *longitudes, double *distances, int count) {
+	int pairs = count - 1;
+	int i = 0;
+
+	nmea_vec_t radius = nmea_vec_splat(NMEA_EARTH_RADIUS);
+	nmea_vec_t deg_to_rad = nmea_vec_splat(NMEA_DEG_TO_RAD);
+	nmea_vec_t half_deg_to_rad = nmea_vec_splat(NMEA_DEG_TO_RAD * 0.5);
+	nmea_vec_t turn = nmea_vec_splat(360.0);
+	nmea_vec_t inverse_turn = nmea_vec_splat(1.0 / 360.0);
+
+	for (; i + NMEA_LANES <= pairs; i += NMEA_LANES) {
+		nmea_vec_t lat1 = nmea_vec_load(latitudes + i);
+		nmea_vec_t lat2 = nmea_vec_load(latitudes + i + 1);
+		nmea_vec_t dlon = nmea_vec_sub(nmea_vec_load(longitudes + i + 1), nmea_vec_load(longitudes + i));
+
+		// Shortest way around the antimeridian
+		dlon = nmea_vec_sub(dlon, nmea_vec_mul(turn, nmea_vec_round(nmea_vec_mul(dlon, inverse_turn))));
+
+		nmea_vec_t unused, cos_lat;
+		nmea_vec_sincos(nmea_vec_mul(nmea_vec_add(lat1, lat2), half_deg_to_rad), &unused, &cos_lat);
+
+		nmea_vec_t dx = nmea_vec_mul(nmea_vec_mul(dlon, deg_to_rad), cos_lat);
+		nmea_vec_t dy = nmea_vec_mul(nmea_vec_sub(lat2, lat1), deg_to_rad);
+
+		nmea_vec_store(distances + i, nmea_vec_mul(radius, nmea_vec_sqrt(nmea_vec_add(nmea_vec_mul(dx, dx), nmea_vec_mul(dy, dy)))));
+	}
+
+	for (; i < pairs; i++) {
+		double dlon = longitudes[i + 1] - longitudes[i];
+		double dx = (dlon - 360.0 * rint(dlon * (1.0 / 360.0))) * NMEA_DEG_TO_RAD * cos((latitudes[i] + latitudes[i + 1]) * (NMEA_DEG_TO_RAD * 0.5));
+		double dy = (latitudes[i + 1] - latitudes[i]) * NMEA_DEG_TO_RAD;
+
+		distances[i] = NMEA_EARTH_RADIUS * sqrt(dx * dx + dy * dy);
+	}
+}
+
+void nmea_get_bearings(const double *latitudes, const double *longitudes, double *bearings, int count) {
+	int pairs = count - 1;
+	int i = 0;
+
+	nmea_vec_t zero = nmea_vec_splat(0.0);
+	nmea_vec_t deg_to_rad = nmea_vec_splat(NMEA_DEG_TO_RAD);
+	nmea_vec_t rad_to_deg = nmea_vec_splat(NMEA_RAD_TO_DEG);
+	nmea_vec_t turn = nmea_vec_splat(360.0);
+
+	for (; i + NMEA_LANES <= pairs; i += NMEA_LANES) {
+		nmea_vec_t dlon = nmea_vec_sub(nmea_vec_load(longitudes + i + 1), nmea_vec_load(longitudes + i));
+
+		nmea_vec_t sin_lat1, cos_lat1, sin_lat2, cos_lat2, sin_dlon, cos_dlon;
+		nmea_vec_sincos(nmea_vec_mul(nmea_vec_load(latitudes + i), deg_to_rad), &sin_lat1, &cos_lat1);
+		nmea_vec_sincos(nmea_vec_mul(nmea_vec_load(latitudes + i + 1), deg_to_rad), &sin_lat2, &cos_lat2);
+		nmea_vec_sincos(nmea_vec_mul(dlon, deg_to_rad), &sin_dlon, &cos_dlon);
+
+		nmea_vec_t y = nmea_vec_mul(sin_dlon, cos_lat2);
+		nmea_vec_t x = nmea_vec_sub(nmea_vec_mul(cos_lat1, sin_lat2), nmea_vec_mul(nmea_vec_mul(sin_lat1, cos_lat2), cos_dlon));
+		nmea_vec_t bearing = nmea_vec_mul(nmea_vec_atan2(y, x), rad_to_deg);
+
+		nmea_vec_store(bearings + i, nmea_vec_select(nmea_vec_lt(bearing, zero), nmea_vec_add(bearing, turn), bearing));
+	}
+
+	for (; i < pairs; i++) {
+		double lat1 = latitudes[i] * NMEA_DEG_TO_RAD;
+		double lat2 = latitudes[i + 1] * NMEA_DEG_TO_RAD;
+		double dlon = (longitudes[i + 1] - longitudes[i]) * NMEA_DEG_TO_RAD;
+
+		double y = sin(dlon) * cos(lat2);
+		double x = cos(lat1) * sin(lat2) - sin(lat1) * cos(lat2) * cos(dlon);
+		double bearing = atan2(y, x) * NMEA_RAD_TO_DEG;
+
+		bearings[i] = bearing < 0.0 ? bearing + 360.0 : bearing;
+	}
+}
+
+void nmea_get_speeds(const double *distances, const uint32_t *times_ms, double *speeds, int count) {
+	// Integer and division work, left to the compiler
+	for (int i = 0; i < count - 1; i++) {
+		// Timestamps are relative to the start of the day, so they wrap around at midnight
+		int32_t elapsed = (int32_t)(times_ms[i + 1] - times_ms[i]);
+		elapsed += elapsed < 0 ? NMEA_DAY_MS : 0;
+
+		// A zero interval results in zero speed
+		speeds[i] = elapsed > 0 ? distances[i] * 1000.0 / elapsed : 0.0;
+	}
+}
+
+#endif // NMEA_GEODESY
@@ -0,0 +1,204 @@
+#include "nmea.h"
+
+#if NMEA_PARSER && NMEA_GSV
+
+#include <string.h>
+
+#define NMEA_GSV_SATELLITES_PER_PART 4
+
+void nmea_gsv_init(nmea_gsv_t *gsv) {
+	memset(gsv, 0, sizeof(nmea_gsv_t));
+}
+
+static int nmea_gsv_count_fields(const char *message) {
+	int fields = 1;
+
+	while (*message != '\0' && *message != '*') {
+		if (*message == ',') {
+			fields++;
+		}
+
+		message++;
+	}
+
+	return fields;
+}
+
+static uint8_t nmea_gsv_read_signal(char **message) {
+	char c;
+
+	if (!nmea_read_char(message, &c)) {
+		return 0;
+	}
+
+	if (c >= '0' && c <= '9') return c - '0';
+	if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+	return 0;
+}
+
+static nmea_gsv_group_t *nmea_gsv_find_group(const nmea_gsv_t *gsv, const char *talker, uint8_t signal) {
+	for (int i = 0; i < NMEA_GSV_MAX_GROUPS; i++) {
+		const nmea_gsv_group_t *group = &gsv->groups[i];
+
+		if (group->used && group->signal == signal && group->talker[0] == talker[0] && group->talker[1] == talker[1]) {
+			return (nmea_gsv_group_t *) group;
+		}
+	}
+
+	return NULL;
+}
+
+static nmea_gsv_group_t *nmea_gsv_add_group(nmea_gsv_t *gsv, const char *talker, uint8_t signal) {
+	for (int i = 0; i < NMEA_GSV_MAX_GROUPS; i++) {
+		nmea_gsv_group_t *group = &gsv->groups[i];
+
+		if (!group->used) {
+			group->used = true;
+			group->talker[0] = talker[0];
+			group->talker[1] = talker[1];
+			group->signal = signal;
+			return group;
+		}
+	}
+
+	return NULL;
+}
+
+nmea_gsv_status_t nmea_gsv_process(nmea_gsv_t *gsv, const char *talker, char *message, uint8_t *signal) {
+	// $GPGSV,3,1,11,03,03,111,00,04,15,270,00,06,01,010,00,13,06,292,00,1*xx
+	int fields = nmea_gsv_count_fields(message);
+
+	if (fields < 3) {
+		return NMEA_GSV_INVALID;
+	}
+
+	uint8_t total_parts = 0, part = 0, total_satellites = 0;
+
+	// Total amount of parts (1-9)
+	nmea_read_uint8(&message, &total_parts);
+
+	// Part number (1-9)
+	nmea_read_uint8(&message, &part);
+
+	// Total amount of satellites in view
+	nmea_read_uint8(&message, &total_satellites);
+
+	if (part < 1 || part > total_parts) {
+		return NMEA_GSV_INVALID;
+	}
+
+	// Each satellite has 4 fields, an extra field means the signal ID is present (NMEA 4.10+)
+	int satellite_fields = fields - 3;
+	int satellite_count = satellite_fields / 4;
+
+	if (satellite_count > NMEA_GSV_SATELLITES_PER_PART) {
+		return NMEA_GSV_INVALID;
+	}
+
+	nmea_satellite_t satellites[NMEA_GSV_SATELLITES_PER_PART];
+
+	for (int i = 0; i < satellite_count; i++) {
+		nmea_satellite_t *sat = &satellites[i];
+		uint8_t elevation = 0;
+
+		sat->prn = 0;
+		sat->azimuth = 0;
+		sat->snr = 0;
+
+		// PRN
+		nmea_read_uint16(&message, &sat->prn);
+
+		// Elevation (degrees)
+		nmea_read_uint8(&message, &elevation);
+		sat->elevation = (int8_t) elevation;
+
+		// Azimuth (degrees)
+		nmea_read_uint16(&message, &sat->azimuth);
+
+		// SNR (dB-Hz), empty when not tracking
+		nmea_read_uint8(&message, &sat->snr);
+	}
+
+	uint8_t signal_id = satellite_fields % 4 == 1 ? nmea_gsv_read_signal(&message) : 0;
+
+	if (signal != NULL) {
+		*signal = signal_id;
+	}
+
+	nmea_gsv_group_t *group = nmea_gsv_find_group(gsv, talker, signal_id);
+
+	if (group == NULL) {
+		group = nmea_gsv_add_group(gsv, talker, signal_id);
+
+		if (group == NULL) {
+			return NMEA_GSV_INVALID;
+		}
+	}
+
+	uint8_t bank = 1 - group->published;
+
+	if (part == 1) {
+		if (group->next_part != 0) {
+			// The previous sequence never received its last part
+			gsv->dropped++;
+		}
+
+		group->total_parts = total_parts;
+		group->total_satellites = total_satellites;
+		group->next_part = 1;
+		group->count[bank] = 0;
+	} else if (group->next_part != part || group->total_parts != total_parts || group->total_satellites != total_satellites) {
+		if (group->next_part != 0) {
+			gsv->dropped++;
+			group->next_part = 0;
+		}
+
+		return NMEA_GSV_OUT_OF_ORDER;
+	}
+
+	// Updates the working bank in place
+	for (int i = 0; i < satellite_count && group->count[bank] < NMEA_GSV_MAX_SATELLITES; i++) {
+		if (satellites[i].prn == 0) {
+			// Empty padding fields in the last part
+			continue;
+		}
+
+		group->satellites[bank][group->count[bank]++] = satellites[i];
+	}
+
+	if (part < total_parts) {
+		group->next_part++;
+		return NMEA_GSV_PENDING;
+	}
+
+	group->next_part = 0;
+
+	// The table may be smaller than the amount of satellites in view
+	uint8_t expected = total_satellites < NMEA_GSV_MAX_SATELLITES ? total_satellites : NMEA_GSV_MAX_SATELLITES;
+
+	if (group->count[bank] != expected) {
+		// The parts don't add up to the announced total, keeps the previous snapshot
+		gsv->dropped++;
+		return NMEA_GSV_INVALID;
+	}
+
+	// Last part, publishes the snapshot
+	group->published = bank;
+	gsv->completed++;
+
+	return NMEA_GSV_COMPLETE;
+}
+
+int nmea_gsv_get_satellites(const nmea_gsv_t *gsv, const char *talker, uint8_t signal, const nmea_satellite_t **satellites) {
+	const nmea_gsv_group_t *group = nmea_gsv_find_group(gsv, talker, signal);
+
+	if (group == NULL) {
+		*satellites = NULL;
+		return 0;
+	}
+
+	*satellites = group->satellites[group->published];
+	return group->count[group->published];
+}
+
+#endif // NMEA_PARSER && NMEA_GSV
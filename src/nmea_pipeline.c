@@ -0,0 +1,268 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "nmea.h"
+
+#if NMEA_PIPELINE
+
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+
+#if (NMEA_PIPELINE_QUEUE_LENGTH & (NMEA_PIPELINE_QUEUE_LENGTH - 1)) != 0
+#error "NMEA_PIPELINE_QUEUE_LENGTH must be a power of two"
+#endif
+
+// Amount of times a worker yields before sleeping while waiting for a batch
+#define NMEA_PIPELINE_SPIN 64
+
+#define NMEA_PIPELINE_FREE 0
+#define NMEA_PIPELINE_FILLED 1
+#define NMEA_PIPELINE_DONE 2
+
+// The slot state is tagged with the batch sequence, so that a stage never mistakes the state of a previous lap for its own
+#define NMEA_PIPELINE_STATE(sequence, phase) ((uint32_t) (sequence) << 2 | (phase))
+
+static uint64_t nmea_pipeline_now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline nmea_pipeline_batch_t *nmea_pipeline_batch(nmea_pipeline_t *pipeline, uint32_t sequence) {
+	return &pipeline->batches[sequence % NMEA_PIPELINE_QUEUE_LENGTH];
+}
+
+static void nmea_pipeline_deliver_ready(nmea_pipeline_t *pipeline) {
+	while (pipeline->deliver_sequence != pipeline->write_sequence) {
+		nmea_pipeline_batch_t *batch = nmea_pipeline_batch(pipeline, pipeline->deliver_sequence);
+
+		if (__atomic_load_n(&batch->state, __ATOMIC_ACQUIRE) != NMEA_PIPELINE_STATE(pipeline->deliver_sequence, NMEA_PIPELINE_DONE)) {
+			// The next batch in sequence is still being decoded
+			return;
+		}
+
+		for (uint32_t i = 0; i < batch->count; i++) {
+			pipeline->deliver(pipeline->context, batch->sentences[i].result.data);
+		}
+
+		uint64_t latency = nmea_pipeline_now_ns() - batch->enqueued_ns;
+
+		if (latency > pipeline->latency_max_ns) {
+			pipeline->latency_max_ns = latency;
+		}
+
+		pipeline->latency_total_ns += latency;
+		pipeline->delivered_batches++;
+
+		// The slot is reused by the batch a lap later
+		__atomic_store_n(&batch->state, NMEA_PIPELINE_STATE(pipeline->deliver_sequence + NMEA_PIPELINE_QUEUE_LENGTH, NMEA_PIPELINE_FREE), __ATOMIC_RELEASE);
+		pipeline->deliver_sequence++;
+	}
+}
+
+static void nmea_pipeline_publish(nmea_pipeline_t *pipeline) {
+	if (pipeline->filling == 0) {
+		// The slot may still hold a batch from the previous lap
+		return;
+	}
+
+	nmea_pipeline_batch_t *batch = nmea_pipeline_batch(pipeline, pipeline->write_sequence);
+	batch->count = pipeline->filling;
+	pipeline->filling = 0;
+
+	batch->enqueued_ns = nmea_pipeline_now_ns();
+
+	// A single store publishes the batch along with everything written before it
+	__atomic_store_n(&batch->state, NMEA_PIPELINE_STATE(pipeline->write_sequence, NMEA_PIPELINE_FILLED), __ATOMIC_SEQ_CST);
+	pipeline->write_sequence++;
+
+	if (__atomic_load_n(&pipeline->sleeping, __ATOMIC_SEQ_CST) > 0) {
+		pthread_mutex_lock(&pipeline->mutex);
+		pthread_cond_broadcast(&pipeline->filled);
+		pthread_mutex_unlock(&pipeline->mutex);
+	}
+}
+
+static void nmea_pipeline_enqueue(void *context, char *message, int length) {
+	nmea_pipeline_t *pipeline = context;
+
+	if (pipeline->worker_count == 0) {
+		// No workers, decodes and delivers in the calling thread
+		nmea_pipeline_sentence_t sentence;
+		pipeline->decode(pipeline->context, message, length, sentence.result.data);
+		pipeline->deliver(pipeline->context, sentence.result.data);
+		return;
+	}
+
+	nmea_pipeline_batch_t *batch = nmea_pipeline_batch(pipeline, pipeline->write_sequence);
+
+	while (pipeline->filling == 0 &&
+		__atomic_load_n(&batch->state, __ATOMIC_ACQUIRE) != NMEA_PIPELINE_STATE(pipeline->write_sequence, NMEA_PIPELINE_FREE)) {
+		// The queue is full, the batch is released once delivered
+		nmea_pipeline_deliver_ready(pipeline);
+		sched_yield();
+	}
+
+	nmea_pipeline_sentence_t *sentence = &batch->sentences[pipeline->filling++];
+	memcpy(sentence->message, message - 2, length + 3); // 3 = the talker ID plus the null terminator
+	sentence->length = length;
+
+	if (pipeline->filling == NMEA_PIPELINE_BATCH_SIZE) {
+		nmea_pipeline_publish(pipeline);
+	}
+}
+
+static bool nmea_pipeline_is_filled(nmea_pipeline_batch_t *batch, uint32_t sequence) {
+	return __atomic_load_n(&batch->state, __ATOMIC_SEQ_CST) == NMEA_PIPELINE_STATE(sequence, NMEA_PIPELINE_FILLED);
+}
+
+static bool nmea_pipeline_wait(nmea_pipeline_t *pipeline, nmea_pipeline_batch_t *batch, uint32_t sequence) {
+	for (int spin = 0; spin < NMEA_PIPELINE_SPIN; spin++) {
+		if (nmea_pipeline_is_filled(batch, sequence)) {
+			return true;
+		}
+
+		if (__atomic_load_n(&pipeline->stopping, __ATOMIC_ACQUIRE)) {
+			return false;
+		}
+
+		sched_yield();
+	}
+
+	// Nothing to decode for a while, sleeps until the framer publishes a batch
+	pthread_mutex_lock(&pipeline->mutex);
+	__atomic_add_fetch(&pipeline->sleeping, 1, __ATOMIC_SEQ_CST);
+
+	while (!nmea_pipeline_is_filled(batch, sequence) && !__atomic_load_n(&pipeline->stopping, __ATOMIC_ACQUIRE)) {
+		pthread_cond_wait(&pipeline->filled, &pipeline->mutex);
+	}
+
+	__atomic_sub_fetch(&pipeline->sleeping, 1, __ATOMIC_SEQ_CST);
+	pthread_mutex_unlock(&pipeline->mutex);
+
+	return nmea_pipeline_is_filled(batch, sequence);
+}
+
+static void *nmea_pipeline_worker(void *arg) {
+	nmea_pipeline_t *pipeline = arg;
+
+	while (true) {
+		// Each batch is claimed by exactly one worker
+		uint32_t sequence = __atomic_fetch_add(&pipeline->claim_sequence, 1, __ATOMIC_ACQ_REL);
+		nmea_pipeline_batch_t *batch = nmea_pipeline_batch(pipeline, sequence);
+
+		if (!nmea_pipeline_wait(pipeline, batch, sequence)) {
+			return NULL;
+		}
+
+		for (uint32_t i = 0; i < batch->count; i++) {
+			nmea_pipeline_sentence_t *sentence = &batch->sentences[i];
+			pipeline->decode(pipeline->context, sentence->message + 2, sentence->length, sentence->result.data);
+		}
+
+		__atomic_store_n(&batch->state, NMEA_PIPELINE_STATE(sequence, NMEA_PIPELINE_DONE), __ATOMIC_RELEASE);
+	}
+}
+
+void nmea_pipeline_init(nmea_pipeline_t *pipeline, nmea_pipeline_decode_t decode, nmea_pipeline_deliver_t deliver, void *context) {
+	nmea_reader_init_with_context(&pipeline->reader, nmea_pipeline_enqueue, pipeline);
+
+	for (int i = 0; i < NMEA_PIPELINE_QUEUE_LENGTH; i++) {
+		pipeline->batches[i].count = 0;
+		pipeline->batches[i].state = NMEA_PIPELINE_STATE(i, NMEA_PIPELINE_FREE);
+	}
+
+	pipeline->decode = decode;
+	pipeline->deliver = deliver;
+	pipeline->context = context;
+	pipeline->write_sequence = 0;
+	pipeline->filling = 0;
+	pipeline->claim_sequence = 0;
+	pipeline->deliver_sequence = 0;
+	pipeline->stopping = false;
+	pipeline->sleeping = 0;
+	pipeline->worker_count = 0;
+	pipeline->latency_max_ns = 0;
+	pipeline->latency_total_ns = 0;
+	pipeline->delivered_batches = 0;
+
+	pthread_mutex_init(&pipeline->mutex, NULL);
+	pthread_cond_init(&pipeline->filled, NULL);
+}
+
+static void nmea_pipeline_join(nmea_pipeline_t *pipeline) {
+	pthread_mutex_lock(&pipeline->mutex);
+	__atomic_store_n(&pipeline->stopping, true, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&pipeline->filled);
+	pthread_mutex_unlock(&pipeline->mutex);
+
+	for (int i = 0; i < pipeline->worker_count; i++) {
+		pthread_join(pipeline->workers[i], NULL);
+	}
+
+	// Back to decoding in the calling thread, workers can be started again
+	pipeline->worker_count = 0;
+	pipeline->stopping = false;
+	pipeline->claim_sequence = pipeline->write_sequence;
+}
+
+bool nmea_pipeline_start(nmea_pipeline_t *pipeline, int workers) {
+	if (workers < 1 || workers > NMEA_PIPELINE_MAX_WORKERS || pipeline->worker_count > 0) {
+		return false;
+	}
+
+	for (int i = 0; i < workers; i++) {
+		if (pthread_create(&pipeline->workers[i], NULL, nmea_pipeline_worker, pipeline) != 0) {
+			// Only the workers started so far are joined
+			nmea_pipeline_join(pipeline);
+			return false;
+		}
+
+		pipeline->worker_count++;
+	}
+
+	return true;
+}
+
+void nmea_pipeline_process_chars(nmea_pipeline_t *pipeline, const char *data, int length) {
+	nmea_reader_t *reader = &pipeline->reader;
+
+	while (length > 0) {
+		// Feeds only what fits, as the reader drops characters when full
+		int free = (NMEA_BUFFER_MAX_LENGTH + reader->buffer_tail - reader->buffer_head - 1) % NMEA_BUFFER_MAX_LENGTH;
+		int chunk = length < free ? length : free;
+
+		nmea_reader_add_chars(reader, data, chunk);
+		nmea_reader_process(reader);
+
+		data += chunk;
+		length -= chunk;
+	}
+
+	// Hands a partial batch over as well, keeping the latency bounded
+	nmea_pipeline_publish(pipeline);
+	nmea_pipeline_deliver_ready(pipeline);
+}
+
+void nmea_pipeline_poll(nmea_pipeline_t *pipeline) {
+	nmea_pipeline_deliver_ready(pipeline);
+}
+
+void nmea_pipeline_flush(nmea_pipeline_t *pipeline) {
+	nmea_pipeline_publish(pipeline);
+
+	while (pipeline->deliver_sequence != pipeline->write_sequence) {
+		nmea_pipeline_deliver_ready(pipeline);
+		sched_yield();
+	}
+}
+
+void nmea_pipeline_stop(nmea_pipeline_t *pipeline) {
+	nmea_pipeline_flush(pipeline);
+	nmea_pipeline_join(pipeline);
+
+	pthread_mutex_destroy(&pipeline->mutex);
+	pthread_cond_destroy(&pipeline->filled);
+}
+
+#endif // NMEA_PIPELINE
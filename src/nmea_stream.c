@@ -1,87 +1,208 @@
 #include <stdlib.h>
 #include "nmea.h"
 
+// Memory ordering between the producer and the consumer, can be overridden for other compilers
+#if defined(NMEA_LOAD_ACQUIRE) && defined(NMEA_STORE_RELEASE)
+// Provided by the build
+#elif defined(__GNUC__) || defined(__clang__)
+#define NMEA_LOAD_ACQUIRE(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define NMEA_STORE_RELEASE(ptr, value) __atomic_store_n(ptr, value, __ATOMIC_RELEASE)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L && !defined(__STDC_NO_ATOMICS__)
+#include <stdatomic.h>
+
+static inline nmea_buffer_index_t nmea_load_acquire(volatile nmea_buffer_index_t* ptr) {
+	nmea_buffer_index_t value = *ptr;
+	atomic_thread_fence(memory_order_acquire);
+	return value;
+}
+
+static inline void nmea_store_release(volatile nmea_buffer_index_t* ptr, nmea_buffer_index_t value) {
+	atomic_thread_fence(memory_order_release);
+	*ptr = value;
+}
+
+static inline uint32_t nmea_load_acquire_u32(volatile uint32_t* ptr) {
+	uint32_t value = *ptr;
+	atomic_thread_fence(memory_order_acquire);
+	return value;
+}
+
+static inline void nmea_store_release_u32(volatile uint32_t* ptr, uint32_t value) {
+	atomic_thread_fence(memory_order_release);
+	*ptr = value;
+}
+
+// Buffer indexes and the overflow counter
+#define NMEA_LOAD_ACQUIRE(ptr) _Generic((ptr), volatile uint32_t*: nmea_load_acquire_u32, default: nmea_load_acquire)(ptr)
+#define NMEA_STORE_RELEASE(ptr, value) _Generic((ptr), volatile uint32_t*: nmea_store_release_u32, default: nmea_store_release)(ptr, value)
+#else
+#error "Define NMEA_LOAD_ACQUIRE and NMEA_STORE_RELEASE for this compiler"
+#endif
+
 static int hex2int(char c);
+#if NMEA_FILTER
+static bool nmea_reader_filter_accepts(nmea_reader_t* reader);
+#endif
 
 void nmea_reader_init(nmea_reader_t* reader, nmea_process_message_t process_message) {
-	reader->length = 0;
 	reader->buffer_head = 0;
 	reader->buffer_tail = 0;
-	reader->buffer_dirty = false;
+	reader->buffer_overflows = 0;
+	reader->buffer_overflows_seen = 0;
+	reader->buffer_seen_head = 0;
+	reader->clear_requested = false;
 	reader->process_message = process_message;
+	reader->process_message_context = NULL;
+	reader->context = NULL;
 	reader->process_error = NULL;
+#if NMEA_FILTER
+	reader->filter_mode = NMEA_FILTER_NONE;
+	reader->filter_ids = NULL;
+	reader->filter_count = 0;
+	reader->filtered = 0;
+#endif
+#if NMEA_DEDUP
+	reader->dedup = NULL;
+	reader->dedup_source = 0;
+#endif
+}
+
+void nmea_reader_init_with_context(nmea_reader_t* reader, nmea_process_message_context_t process_message, void* context) {
+	nmea_reader_init(reader, NULL);
+	reader->process_message_context = process_message;
+	reader->context = context;
 }
 
 void nmea_reader_set_error_callback(nmea_reader_t* reader, nmea_process_error_t process_error) {
 	reader->process_error = process_error;
 }
 
+#if NMEA_FILTER
+void nmea_reader_set_filter(nmea_reader_t* reader, nmea_filter_mode_t mode, const char* const* ids, uint8_t count) {
+	reader->filter_mode = mode;
+	reader->filter_ids = ids;
+	reader->filter_count = count;
+}
+#endif
+
+#if NMEA_DEDUP
+void nmea_reader_set_dedup(nmea_reader_t* reader, nmea_dedup_t* dedup, uint8_t source) {
+	reader->dedup = dedup;
+	reader->dedup_source = source;
+}
+#endif
+
 void nmea_reader_process_char(nmea_reader_t* reader, char c) {
 	nmea_reader_add_char(reader, c);
 	nmea_reader_process(reader);
 }
 
 void nmea_reader_add_char(nmea_reader_t* reader, char c) {
-	int index = (reader->buffer_head + 1) % NMEA_BUFFER_MAX_LENGTH;
+	nmea_buffer_index_t head = reader->buffer_head;
+	nmea_buffer_index_t index = (head + 1) % NMEA_BUFFER_MAX_LENGTH;
+
+	if (index == NMEA_LOAD_ACQUIRE(&reader->buffer_tail)) {
+		// The buffer is full, the error is dispatched by the consumer
+		NMEA_STORE_RELEASE(&reader->buffer_overflows, reader->buffer_overflows + 1);
+		return;
+	}
 
-	reader->buffer[reader->buffer_head] = c;
-	reader->buffer_head = index;
-	reader->buffer_dirty = true;
+	reader->buffer[head] = c;
+	NMEA_STORE_RELEASE(&reader->buffer_head, index);
+}
 
-	if (reader->length == NMEA_BUFFER_MAX_LENGTH) {
-		reader->buffer_tail = (reader->buffer_tail + 1) % NMEA_BUFFER_MAX_LENGTH;
+void nmea_reader_add_chars(nmea_reader_t* reader, const char* data, int length) {
+	nmea_buffer_index_t head = reader->buffer_head;
+	nmea_buffer_index_t tail = NMEA_LOAD_ACQUIRE(&reader->buffer_tail);
+	int free = (NMEA_BUFFER_MAX_LENGTH + tail - head - 1) % NMEA_BUFFER_MAX_LENGTH;
 
-		// Dispatch an error
-		if (reader->process_error != NULL) {
-			// TODO check error handling
-			reader->process_error(NMEA_ERROR_BUFFER_OVERFLOW, reader->buffer, NMEA_BUFFER_MAX_LENGTH - 1);
-		}
+	if (length > free) {
+		// The buffer is full, the error is dispatched by the consumer
+		NMEA_STORE_RELEASE(&reader->buffer_overflows, reader->buffer_overflows + 1);
+		length = free;
 	}
-	else {
-		reader->length++;
+
+	for (int i = 0; i < length; i++) {
+		reader->buffer[head] = data[i];
+		head = (head + 1) % NMEA_BUFFER_MAX_LENGTH;
 	}
+
+	// Publishes the whole block at once
+	NMEA_STORE_RELEASE(&reader->buffer_head, head);
 }
 
 void nmea_reader_clear(nmea_reader_t* reader) {
-	reader->buffer_head = 0;
-	reader->buffer_tail = 0;
-	reader->length = 0;
-	reader->buffer_dirty = false;
+	reader->clear_requested = true;
 }
 
-void nmea_reader_process(nmea_reader_t* reader) {
-	if (!reader->buffer_dirty) {
-		return;
+static inline void nmea_reader_consume(nmea_reader_t* reader, nmea_buffer_index_t tail) {
+	// Hands the space back to the producer
+	NMEA_STORE_RELEASE(&reader->buffer_tail, tail);
+}
+
+static bool nmea_reader_process_message(nmea_reader_t* reader, nmea_buffer_index_t head) {
+	nmea_buffer_index_t tail = reader->buffer_tail;
+
+	while (tail != head && reader->buffer[tail] != '$') {
+		tail = (tail + 1) % NMEA_BUFFER_MAX_LENGTH;
 	}
 
-	reader->buffer_dirty = false;
+	nmea_reader_consume(reader, tail);
 
-	while (reader->buffer[reader->buffer_tail] != '$') {
-		reader->buffer_tail = (reader->buffer_tail + 1) % NMEA_BUFFER_MAX_LENGTH;
+	if (tail == head) {
+		// No start of message found yet, we'll need to buffer more
+		return false;
+	}
 
-		if (reader->buffer_tail == reader->buffer_head) {
-			// No start of message found yet, we'll need to buffer more
-			return;
+	int available = (NMEA_BUFFER_MAX_LENGTH + head - tail) % NMEA_BUFFER_MAX_LENGTH;
+
+#if NMEA_FILTER
+	if (reader->filter_mode != NMEA_FILTER_NONE) {
+		if (available < 6) { // 6 = checks for the $ plus the talker ID and sentence type
+			// No sentence type found yet, we'll need to buffer more
+			return false;
+		}
+
+		if (!nmea_reader_filter_accepts(reader)) {
+			// Skips to the next $ without copying the sentence
+			reader->filtered++;
+			nmea_reader_consume(reader, (tail + 1) % NMEA_BUFFER_MAX_LENGTH);
+			return true;
 		}
 	}
+#endif
 
-	nmea_buffer_index_t gps_buffer_end = reader->buffer_tail;
+	int end = 1;
 
-	while (reader->buffer[gps_buffer_end] != '*') {
-		gps_buffer_end = (gps_buffer_end + 1) % NMEA_BUFFER_MAX_LENGTH;
+	while (true) {
+		if (available - end < 3) { // 3 = checks for the two hex characters plus the *
+			// No end of message found yet, we'll need to buffer more
+			return false;
+		}
 
-		int distance_from_end = (NMEA_BUFFER_MAX_LENGTH + reader->buffer_head - gps_buffer_end) % NMEA_BUFFER_MAX_LENGTH;
+		if (reader->buffer[(tail + end) % NMEA_BUFFER_MAX_LENGTH] == '*') {
+			break;
+		}
 
-		if (distance_from_end < 3) { // 3 = checks for the two hex characters plus the *
-			// No end of message found yet, we'll need to buffer more
-			return;
+		if (end >= NMEA_MESSAGE_BUFFER_MAX_LENGTH) {
+			// The message can't fit the message buffer, skips to the next $
+			nmea_reader_consume(reader, (tail + 1) % NMEA_BUFFER_MAX_LENGTH);
+
+			if (reader->process_error != NULL) {
+				reader->process_error(NMEA_ERROR_BUFFER_OVERFLOW, reader->message, 0);
+			}
+
+			return true;
 		}
+
+		end++;
 	}
 
 	// Calculates the message checksum and fills the message buffer
 	uint8_t checksum = 0;
-	nmea_buffer_index_t i = reader->buffer_tail + 1;
+	nmea_buffer_index_t i = (tail + 1) % NMEA_BUFFER_MAX_LENGTH;
 	nmea_buffer_index_t msg_index = 0;
+	nmea_buffer_index_t gps_buffer_end = (tail + end) % NMEA_BUFFER_MAX_LENGTH;
 
 	while (i != gps_buffer_end) {
 		checksum ^= reader->buffer[i];
@@ -100,9 +221,8 @@ void nmea_reader_process(nmea_reader_t* reader) {
 	char* message = reader->message + 2; // 2 = skips $GN
 	int size = msg_index - 2;
 
-	// Reset counts to read a new message
-	reader->length = 0;
-	reader->buffer_tail = (gps_buffer_end + 3) % NMEA_BUFFER_MAX_LENGTH;
+	// The message was copied, the producer can reuse its space
+	nmea_reader_consume(reader, (gps_buffer_end + 3) % NMEA_BUFFER_MAX_LENGTH);
 
 	if (checksum != chk) {
 		// Checksum doesn't match, we can't trust the data
@@ -110,11 +230,81 @@ void nmea_reader_process(nmea_reader_t* reader) {
 			reader->process_error(NMEA_ERROR_CHECKSUM, message, size);
 		}
 
+		return true;
+	}
+
+#if NMEA_DEDUP
+	if (reader->dedup != NULL && !nmea_dedup_accept(reader->dedup, reader->dedup_source, reader->message, msg_index, checksum)) {
+		// Already forwarded by another source, or not coming from the preferred source
+		return true;
+	}
+#endif
+
+	if (reader->process_message_context != NULL) {
+		reader->process_message_context(reader->context, message, size);
+	} else {
+		reader->process_message(message, size);
+	}
+
+	return true;
+}
+
+void nmea_reader_process(nmea_reader_t* reader) {
+	if (reader->clear_requested) {
+		reader->clear_requested = false;
+		nmea_reader_consume(reader, NMEA_LOAD_ACQUIRE(&reader->buffer_head));
+	}
+
+	uint32_t overflows = NMEA_LOAD_ACQUIRE(&reader->buffer_overflows);
+
+	if (overflows != reader->buffer_overflows_seen) {
+		reader->buffer_overflows_seen = overflows;
+
+		// Dispatch an error, the buffer isn't forwarded as the producer may still be writing to it
+		if (reader->process_error != NULL) {
+			reader->process_error(NMEA_ERROR_BUFFER_OVERFLOW, NULL, 0);
+		}
+	}
+
+	nmea_buffer_index_t head = NMEA_LOAD_ACQUIRE(&reader->buffer_head);
+
+	if (head == reader->buffer_seen_head) {
+		// Nothing new was appended since the last call
 		return;
 	}
 
-	reader->process_message(message, size);
+	reader->buffer_seen_head = head;
+
+	while (nmea_reader_process_message(reader, head)) {
+		// Keeps going until there are no full messages left
+	}
+}
+
+#if NMEA_FILTER
+static bool nmea_reader_filter_accepts(nmea_reader_t* reader) {
+	for (uint8_t i = 0; i < reader->filter_count; i++) {
+		const char* id = reader->filter_ids[i];
+		nmea_buffer_index_t index = reader->buffer_tail;
+		bool matches = true;
+
+		// Compares the talker ID and sentence type that follow the $
+		for (int j = 0; j < 5 && id[j] != '\0'; j++) {
+			index = (index + 1) % NMEA_BUFFER_MAX_LENGTH;
+
+			if (id[j] != '?' && id[j] != reader->buffer[index]) {
+				matches = false;
+				break;
+			}
+		}
+
+		if (matches) {
+			return reader->filter_mode == NMEA_FILTER_ALLOW;
+		}
+	}
+
+	return reader->filter_mode != NMEA_FILTER_ALLOW;
 }
+#endif
 
 static int hex2int(char c) {
 	if (c >= '0' && c <= '9') return c - '0';
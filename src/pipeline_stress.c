@@ -0,0 +1,113 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "nmea.h"
+
+// Feeds numbered sentences through the pipeline and checks that every one is delivered once, in order
+// Build it with a small NMEA_PIPELINE_QUEUE_LENGTH so that the workers outnumber the slots and laps overlap
+
+#define SENTENCES 50000
+#define RUNS 20
+#define TIMEOUT_S 60
+
+typedef struct {
+	uint32_t number;
+} result_t;
+
+static char stream[SENTENCES * 32];
+static int stream_length = 0;
+
+static uint32_t delivered = 0;
+static uint32_t out_of_order = 0;
+
+static void decode(void *context, char *message, int length, void *result) {
+	(void) context;
+	(void) length;
+
+	// TXT,<number>
+	char type[4];
+	nmea_read_string(&message, type, 4);
+	nmea_read_uint32(&message, &((result_t *) result)->number);
+
+	// Preempts some workers mid-batch, widening the windows between the pipeline stages
+	if (rand() % 64 == 0) {
+		struct timespec pause = { 0, 20000 };
+		nanosleep(&pause, NULL);
+	}
+}
+
+static void deliver(void *context, void *result) {
+	(void) context;
+
+	if (((result_t *) result)->number != delivered) {
+		out_of_order++;
+	}
+
+	delivered++;
+}
+
+static void timeout(int signal) {
+	(void) signal;
+	static const char error[] = "Timed out, the pipeline is stuck\n";
+	write(STDERR_FILENO, error, sizeof(error) - 1);
+	_exit(EXIT_FAILURE);
+}
+
+static void build_stream(void) {
+	for (int i = 0; i < SENTENCES; i++) {
+		char body[24];
+		int length = snprintf(body, sizeof(body), "GPTXT,%d", i);
+		uint8_t checksum = 0;
+
+		for (int j = 0; j < length; j++) {
+			checksum ^= body[j];
+		}
+
+		stream_length += sprintf(stream + stream_length, "$%s*%02X\r\n", body, checksum);
+	}
+}
+
+int main(void) {
+	static nmea_pipeline_t pipeline;
+	int failures = 0;
+
+	build_stream();
+	signal(SIGALRM, timeout);
+
+	for (int run = 0; run < RUNS; run++) {
+		int workers = 1 + run % NMEA_PIPELINE_MAX_WORKERS;
+		int block = 64 << (run % 6); // Different block sizes produce partial batches
+
+		delivered = 0;
+		out_of_order = 0;
+		alarm(TIMEOUT_S);
+
+		nmea_pipeline_init(&pipeline, decode, deliver, NULL);
+
+		if (!nmea_pipeline_start(&pipeline, workers)) {
+			printf("run %2d: couldn't start %d workers\n", run, workers);
+			return EXIT_FAILURE;
+		}
+
+		for (int offset = 0; offset < stream_length; offset += block) {
+			int length = stream_length - offset < block ? stream_length - offset : block;
+			nmea_pipeline_process_chars(&pipeline, stream + offset, length);
+		}
+
+		nmea_pipeline_stop(&pipeline);
+		alarm(0);
+
+		bool ok = delivered == SENTENCES && out_of_order == 0;
+		failures += !ok;
+
+		printf("run %2d: %d workers, %d slots, %5d byte blocks: %u delivered, %u out of order %s\n",
+			run, workers, NMEA_PIPELINE_QUEUE_LENGTH, block, delivered, out_of_order, ok ? "OK" : "FAIL");
+	}
+
+	return failures > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}